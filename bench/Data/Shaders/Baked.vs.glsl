@@ -0,0 +1,10 @@
+#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+#include "Include/VertexPositionUv.glsl"
+
+void main()
+{
+    gl_Position = vec4(i_position, 1.0);
+    v_uv = i_uv;
+}
@@ -0,0 +1,10 @@
+#version 450 core
+
+layout(location = 0) in vec2 v_uv;
+
+layout(location = 0) out vec4 o_color;
+
+void main()
+{
+    o_color = vec4(v_uv, 0.5f, 1.0f);
+}
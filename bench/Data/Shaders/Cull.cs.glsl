@@ -0,0 +1,76 @@
+#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+#include "Include/InstanceData.glsl"
+
+layout(local_size_x = 64) in;
+
+// CullingObject from Shared/GpuCulling.hpp
+struct CullingObject
+{
+    vec4 BoundingSphere;
+    uint IndexCount;
+    uint FirstIndex;
+    int BaseVertex;
+    uint Padding;
+};
+
+// DrawElementsIndirectCommand from Shared/DrawBatcher.hpp
+struct DrawElementsIndirectCommand
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int BaseVertex;
+    uint BaseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceBuffer
+{
+    InstanceData instances[];
+};
+
+layout(std430, binding = 1) readonly buffer ObjectBuffer
+{
+    CullingObject objects[];
+};
+
+layout(std430, binding = 2) writeonly buffer CommandBuffer
+{
+    DrawElementsIndirectCommand commands[];
+};
+
+layout(std430, binding = 3) buffer DrawCountBuffer
+{
+    uint drawCount;
+};
+
+layout(location = 0) uniform vec4 u_frustumPlanes[6];
+layout(location = 6) uniform uint u_objectCount;
+
+void main()
+{
+    uint objectIndex = gl_GlobalInvocationID.x;
+    if (objectIndex >= u_objectCount)
+    {
+        return;
+    }
+
+    CullingObject object = objects[objectIndex];
+    InstanceData instance = instances[objectIndex];
+
+    vec3 center = TransformByInstance(object.BoundingSphere.xyz, instance.TranslationScale, instance.Rotation);
+    float radius = object.BoundingSphere.w * instance.TranslationScale.w;
+
+    for (int planeIndex = 0; planeIndex < 6; planeIndex++)
+    {
+        if (dot(u_frustumPlanes[planeIndex], vec4(center, 1.0)) < -radius)
+        {
+            return;
+        }
+    }
+
+    // survivors end up in whatever order the atomic hands out slots, BaseInstance finds the instance again
+    uint commandIndex = atomicAdd(drawCount, 1u);
+    commands[commandIndex] = DrawElementsIndirectCommand(object.IndexCount, 1u, object.FirstIndex, object.BaseVertex, objectIndex);
+}
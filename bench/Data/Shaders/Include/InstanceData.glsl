@@ -0,0 +1,15 @@
+// InstanceData from Shared/InstanceData.hpp, Color is packed rgba8
+struct InstanceData
+{
+    vec4 TranslationScale;
+    vec4 Rotation;
+    uint Color;
+    uint MaterialIndex;
+};
+
+vec3 TransformByInstance(vec3 position, vec4 translationScale, vec4 rotation)
+{
+    position *= translationScale.w;
+    position += 2.0 * cross(rotation.xyz, cross(rotation.xyz, position) + rotation.w * position);
+    return position + translationScale.xyz;
+}
@@ -0,0 +1,14 @@
+#version 450 core
+
+layout(location = 0) in vec2 v_uv;
+layout(location = 1) in vec4 v_color;
+layout(location = 2) flat in uint v_materialIndex;
+
+layout(location = 0) out vec4 o_color;
+
+void main()
+{
+    // odd materials come out darker, so every instance attribute reaches the output
+    float materialShade = (v_materialIndex & 1u) != 0u ? 0.8f : 1.0f;
+    o_color = vec4(v_uv, 0.5f, 1.0f) * v_color * materialShade;
+}
@@ -0,0 +1,21 @@
+#version 450 core
+#extension GL_GOOGLE_include_directive : require
+
+#include "Include/VertexPositionUv.glsl"
+#include "Include/InstanceData.glsl"
+
+layout(location = 2) in vec4 i_instanceTranslationScale;
+layout(location = 3) in vec4 i_instanceRotation;
+layout(location = 4) in vec4 i_instanceColor;
+layout(location = 5) in uint i_instanceMaterialIndex;
+
+layout(location = 1) out vec4 v_color;
+layout(location = 2) flat out uint v_materialIndex;
+
+void main()
+{
+    gl_Position = vec4(TransformByInstance(i_position, i_instanceTranslationScale, i_instanceRotation), 1.0);
+    v_uv = i_uv;
+    v_color = i_instanceColor;
+    v_materialIndex = i_instanceMaterialIndex;
+}
@@ -0,0 +1,26 @@
+#version 450 core
+#extension GL_GOOGLE_include_directive : require
+// gl_BaseInstance is core in 4.6 only, the extension also covers 4.5 drivers
+#extension GL_ARB_shader_draw_parameters : require
+
+#include "Include/VertexPositionUv.glsl"
+#include "Include/InstanceData.glsl"
+
+layout(std430, binding = 0) readonly buffer InstanceBuffer
+{
+    InstanceData instances[];
+};
+
+layout(location = 0) uniform mat4 u_viewProjection;
+
+layout(location = 1) out vec4 v_color;
+layout(location = 2) flat out uint v_materialIndex;
+
+void main()
+{
+    InstanceData instance = instances[gl_BaseInstanceARB + gl_InstanceID];
+    gl_Position = u_viewProjection * vec4(TransformByInstance(i_position, instance.TranslationScale, instance.Rotation), 1.0);
+    v_uv = i_uv;
+    v_color = unpackUnorm4x8(instance.Color);
+    v_materialIndex = instance.MaterialIndex;
+}
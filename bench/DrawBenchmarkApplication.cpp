@@ -0,0 +1,703 @@
+#include "DrawBenchmarkApplication.hpp"
+#include "../src/Shared/InstanceData.hpp"
+#include "../src/Shared/VertexLayout.hpp"
+#include "../src/Shared/VertexPositionUv.hpp"
+
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <fstream>
+
+std::string_view GetSubmissionStrategyName(SubmissionStrategy strategy)
+{
+    switch (strategy)
+    {
+        case SubmissionStrategy::PerObjectBuffers: return "PerObjectBuffers";
+        case SubmissionStrategy::SharedBuffersBaseVertex: return "SharedBuffersBaseVertex";
+        case SubmissionStrategy::Instanced: return "Instanced";
+        case SubmissionStrategy::InstancedStorageBuffer: return "InstancedStorageBuffer";
+        case SubmissionStrategy::MultiDrawIndirect: return "MultiDrawIndirect";
+        case SubmissionStrategy::BatchedMultiDrawIndirect: return "BatchedMultiDrawIndirect";
+        case SubmissionStrategy::GpuCulledIndirect: return "GpuCulledIndirect";
+        default: return "Unknown";
+    }
+}
+
+DrawBenchmarkApplication::DrawBenchmarkApplication(DrawBenchmarkSettings benchmarkSettings)
+    : _benchmarkSettings(std::move(benchmarkSettings)),
+      _submissionTimes(std::max(_benchmarkSettings.MeasuredFrameCount, 1u)),
+      _frameTimes(std::max(_benchmarkSettings.MeasuredFrameCount, 1u))
+{
+    // the benchmark is meant for build machines, OGS_HEADLESS=0 still forces a window
+    settings.IsHeadless = true;
+}
+
+bool DrawBenchmarkApplication::Load()
+{
+    if (!Application::Load())
+    {
+        return false;
+    }
+
+    // gl_BaseInstance needs 4.6 or ARB_shader_draw_parameters, the 4.5 fallback context may have neither
+    auto isShaderDrawParametersSupported = GLAD_GL_VERSION_4_6 != 0 || GLAD_GL_ARB_shader_draw_parameters != 0;
+    if (!isShaderDrawParametersSupported)
+    {
+        DropStrategy(SubmissionStrategy::InstancedStorageBuffer, "GL 4.6 or ARB_shader_draw_parameters is missing");
+        DropStrategy(SubmissionStrategy::GpuCulledIndirect, "GL 4.6 or ARB_shader_draw_parameters is missing");
+    }
+
+    if (!GpuCulling::IsSupported())
+    {
+        DropStrategy(SubmissionStrategy::GpuCulledIndirect, "GL 4.6 or ARB_indirect_parameters is missing");
+    }
+
+    std::vector<ProgramDescription> programDescriptions =
+    {
+        { .Label = "Baked", .VertexShaderFilePath = "Data/Shaders/Baked.vs.glsl", .FragmentShaderFilePath = "Data/Shaders/Color.fs.glsl", .ComputeShaderFilePath = "", .Defines = {} },
+        { .Label = "Instanced", .VertexShaderFilePath = "Data/Shaders/Instanced.vs.glsl", .FragmentShaderFilePath = "Data/Shaders/Instanced.fs.glsl", .ComputeShaderFilePath = "", .Defines = {} },
+    };
+
+    auto isInstancedStorageNeeded =
+        IsStrategyRequested(SubmissionStrategy::InstancedStorageBuffer) ||
+        IsStrategyRequested(SubmissionStrategy::GpuCulledIndirect);
+    if (isInstancedStorageNeeded)
+    {
+        programDescriptions.push_back({ .Label = "InstancedStorage", .VertexShaderFilePath = "Data/Shaders/InstancedStorage.vs.glsl", .FragmentShaderFilePath = "Data/Shaders/Instanced.fs.glsl", .ComputeShaderFilePath = "", .Defines = {} });
+    }
+
+    // Baked and Instanced come first, the strategies that can not be skipped draw with them
+    constexpr size_t requiredProgramCount = 2;
+    auto createProgramResults = CreatePrograms(programDescriptions);
+    for (size_t programIndex = 0; programIndex < requiredProgramCount; programIndex++)
+    {
+        if (!createProgramResults[programIndex].has_value())
+        {
+            spdlog::error("Building Program {} failed. {}", programDescriptions[programIndex].Label, createProgramResults[programIndex].error());
+            return false;
+        }
+    }
+
+    _bakedProgram = createProgramResults[0].value();
+    _instancedProgram = createProgramResults[1].value();
+
+    // the strategies built on it are optional, a driver that can't build it just skips them
+    if (isInstancedStorageNeeded)
+    {
+        if (createProgramResults[2].has_value())
+        {
+            _instancedStorageProgram = createProgramResults[2].value();
+        }
+        else
+        {
+            spdlog::warn("Building Program {} failed. {}", "InstancedStorage", createProgramResults[2].error());
+            DropStrategy(SubmissionStrategy::InstancedStorageBuffer, "its program did not build");
+            DropStrategy(SubmissionStrategy::GpuCulledIndirect, "its program did not build");
+        }
+    }
+
+    // an empty --draws leaves no cases, which is reported below
+    auto& drawCounts = _benchmarkSettings.DrawCounts;
+    auto maxDrawCount = drawCounts.empty() ? 0u : *std::max_element(drawCounts.begin(), drawCounts.end());
+    if (IsStrategyRequested(SubmissionStrategy::GpuCulledIndirect) && maxDrawCount > 0)
+    {
+        auto cullProgramResult = CreateComputeProgram("Cull", "Data/Shaders/Cull.cs.glsl");
+        if (!cullProgramResult.has_value())
+        {
+            spdlog::warn("Building Program Cull failed. {}", cullProgramResult.error());
+            DropStrategy(SubmissionStrategy::GpuCulledIndirect, "its program did not build");
+        }
+        else
+        {
+            _cullProgram = cullProgramResult.value();
+            if (!_gpuCulling.Initialize("Bench", maxDrawCount))
+            {
+                DropStrategy(SubmissionStrategy::GpuCulledIndirect, "its buffers could not be created");
+            }
+        }
+    }
+
+    for (auto triangleCount : _benchmarkSettings.TriangleCounts)
+    {
+        for (auto drawCount : _benchmarkSettings.DrawCounts)
+        {
+            if (drawCount == 0 || drawCount > triangleCount)
+            {
+                continue;
+            }
+
+            for (auto strategy : _benchmarkSettings.Strategies)
+            {
+                _cases.push_back({ .Strategy = strategy, .TriangleCount = triangleCount, .DrawCount = drawCount });
+            }
+        }
+    }
+
+    if (_cases.empty())
+    {
+        spdlog::error("Bench: No benchmark cases, every draw count is larger than every triangle count or no strategy is left");
+        return false;
+    }
+
+    _bakedInputLayout = CreateInputLayout("Baked", VertexTraits<VertexPositionUv>::Elements);
+
+    // binding 1 advances once per instance, one InstanceData each
+    constexpr auto instancedElements = ConcatenateInputLayoutElements(
+        VertexTraits<VertexPositionUv>::Elements,
+        VertexTraits<InstanceData>::GetElements(2, 1, 1));
+    _instancedInputLayout = CreateInputLayout("Instanced", instancedElements);
+
+    if (!_drawBatcher.Initialize("Bench", maxDrawCount))
+    {
+        return false;
+    }
+
+    stateCache.SetClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+
+    spdlog::info("Bench: Running {} cases, {} warmup and {} measured frames each", _cases.size(), _benchmarkSettings.WarmupFrameCount, _benchmarkSettings.MeasuredFrameCount);
+
+    CreateScene(_cases.front());
+
+    return true;
+}
+
+bool DrawBenchmarkApplication::IsStrategyRequested(SubmissionStrategy strategy) const
+{
+    auto& strategies = _benchmarkSettings.Strategies;
+    return std::find(strategies.begin(), strategies.end(), strategy) != strategies.end();
+}
+
+void DrawBenchmarkApplication::DropStrategy(
+    SubmissionStrategy strategy,
+    std::string_view reason)
+{
+    if (std::erase(_benchmarkSettings.Strategies, strategy) > 0)
+    {
+        spdlog::warn("Bench: Skipping {}, {}", GetSubmissionStrategyName(strategy), reason);
+    }
+}
+
+void DrawBenchmarkApplication::Unload()
+{
+    if (_currentCase < _cases.size())
+    {
+        DestroyScene();
+    }
+
+    _drawBatcher.Destroy();
+    _gpuCulling.Destroy();
+
+    DeleteProgram(_bakedProgram);
+    DeleteProgram(_instancedProgram);
+    DeleteProgram(_instancedStorageProgram);
+    DeleteProgram(_cullProgram);
+
+    Application::Unload();
+}
+
+void DrawBenchmarkApplication::Render()
+{
+    auto frameStartTime = FrameClock::now();
+
+    Application::Render();
+
+    if (_currentCase >= _cases.size())
+    {
+        return;
+    }
+
+    auto submissionStartTime = FrameClock::now();
+
+    SubmitDraws();
+
+    auto submissionEndTime = FrameClock::now();
+
+    // waiting for the gpu here makes frame time include the execution of everything just submitted
+    glFinish();
+
+    auto frameEndTime = FrameClock::now();
+
+    if (_currentFrame >= _benchmarkSettings.WarmupFrameCount)
+    {
+        _submissionTimes.Add(MillisecondsBetween(submissionStartTime, submissionEndTime));
+        _frameTimes.Add(MillisecondsBetween(frameStartTime, frameEndTime));
+    }
+
+    _currentFrame++;
+    if (_currentFrame == _benchmarkSettings.WarmupFrameCount + _benchmarkSettings.MeasuredFrameCount)
+    {
+        AdvanceCase();
+    }
+}
+
+void DrawBenchmarkApplication::OnProgramReloaded(const Program& program)
+{
+    // every uniform is set right before its draw or dispatch, keeping the new stages is enough
+    auto programs = std::to_array<Program*>({ &_bakedProgram, &_instancedProgram, &_instancedStorageProgram, &_cullProgram });
+    for (auto ownProgram : programs)
+    {
+        if (ownProgram->Id == program.Id)
+        {
+            *ownProgram = program;
+        }
+    }
+}
+
+void DrawBenchmarkApplication::CreateScene(const DrawBenchmarkCase& benchmarkCase)
+{
+    _trianglesPerDraw = std::max(1u, benchmarkCase.TriangleCount / benchmarkCase.DrawCount);
+    _verticesPerDraw = _trianglesPerDraw * 3;
+    _indicesPerDraw = _trianglesPerDraw * 3;
+
+    // one mesh filling the unit square, every object is a scaled and offset copy of it
+    std::vector<VertexPositionUv> localVertices;
+    std::vector<uint32_t> localIndices;
+    localVertices.reserve(_verticesPerDraw);
+    localIndices.reserve(_indicesPerDraw);
+
+    auto trianglesPerRow = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(_trianglesPerDraw))));
+    auto cellSize = 1.0f / static_cast<float>(trianglesPerRow);
+    for (uint32_t triangleIndex = 0; triangleIndex < _trianglesPerDraw; triangleIndex++)
+    {
+        auto left = static_cast<float>(triangleIndex % trianglesPerRow) * cellSize;
+        auto bottom = static_cast<float>(triangleIndex / trianglesPerRow) * cellSize;
+
+        auto corners = std::to_array<glm::vec2>(
+        {
+            glm::vec2(left + 0.1f * cellSize, bottom + 0.1f * cellSize),
+            glm::vec2(left + 0.9f * cellSize, bottom + 0.1f * cellSize),
+            glm::vec2(left + 0.5f * cellSize, bottom + 0.9f * cellSize)
+        });
+
+        for (auto& corner : corners)
+        {
+            localIndices.push_back(static_cast<uint32_t>(localVertices.size()));
+            localVertices.push_back({ .Position = glm::vec3(corner.x, corner.y, 0.0f), .Uv = corner });
+        }
+    }
+
+    auto objectsPerRow = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(benchmarkCase.DrawCount))));
+    auto objectSize = 2.0f / static_cast<float>(objectsPerRow);
+    auto getObjectOffset = [&](uint32_t objectIndex)
+    {
+        return glm::vec2(
+            -1.0f + static_cast<float>(objectIndex % objectsPerRow) * objectSize,
+            -1.0f + static_cast<float>(objectIndex / objectsPerRow) * objectSize);
+    };
+
+    auto bakeObjectVertices = [&](uint32_t objectIndex, VertexPositionUv* vertices)
+    {
+        auto objectOffset = getObjectOffset(objectIndex);
+        for (auto& localVertex : localVertices)
+        {
+            *vertices++ =
+            {
+                .Position = glm::vec3(localVertex.Position.x * objectSize + objectOffset.x, localVertex.Position.y * objectSize + objectOffset.y, 0.0f),
+                .Uv = localVertex.Uv
+            };
+        }
+    };
+
+    auto localIndicesSize = localIndices.size() * sizeof(uint32_t);
+
+    switch (benchmarkCase.Strategy)
+    {
+        case SubmissionStrategy::PerObjectBuffers:
+        {
+            _objectVertexBuffers.resize(benchmarkCase.DrawCount);
+            _objectIndexBuffers.resize(benchmarkCase.DrawCount);
+            glCreateBuffers(benchmarkCase.DrawCount, _objectVertexBuffers.data());
+            glCreateBuffers(benchmarkCase.DrawCount, _objectIndexBuffers.data());
+
+            std::vector<VertexPositionUv> objectVertices(_verticesPerDraw);
+            for (uint32_t objectIndex = 0; objectIndex < benchmarkCase.DrawCount; objectIndex++)
+            {
+                bakeObjectVertices(objectIndex, objectVertices.data());
+                glNamedBufferStorage(_objectVertexBuffers[objectIndex], objectVertices.size() * sizeof(VertexPositionUv), objectVertices.data(), 0);
+                glNamedBufferStorage(_objectIndexBuffers[objectIndex], localIndicesSize, localIndices.data(), 0);
+            }
+
+            renderCounters.UploadedBytes += benchmarkCase.DrawCount * (_verticesPerDraw * sizeof(VertexPositionUv) + localIndicesSize);
+            break;
+        }
+        case SubmissionStrategy::SharedBuffersBaseVertex:
+        case SubmissionStrategy::MultiDrawIndirect:
+        {
+            // objects bake into disjoint slices, up to a million vertices are worth spreading over the workers
+            std::vector<VertexPositionUv> vertices(static_cast<size_t>(benchmarkCase.DrawCount) * _verticesPerDraw);
+            GetJobSystem().ParallelFor(benchmarkCase.DrawCount, std::max(1u, 16384 / _verticesPerDraw), [&](uint32_t firstObject, uint32_t lastObject)
+            {
+                for (uint32_t objectIndex = firstObject; objectIndex < lastObject; objectIndex++)
+                {
+                    bakeObjectVertices(objectIndex, vertices.data() + static_cast<size_t>(objectIndex) * _verticesPerDraw);
+                }
+            });
+
+            glCreateBuffers(1, &_vertexBuffer);
+            glNamedBufferStorage(_vertexBuffer, vertices.size() * sizeof(VertexPositionUv), vertices.data(), 0);
+            glCreateBuffers(1, &_indexBuffer);
+            glNamedBufferStorage(_indexBuffer, localIndicesSize, localIndices.data(), 0);
+
+            _bakedInputLayout.AddVertexBufferBinding(_vertexBuffer, 0, 0, sizeof(VertexPositionUv));
+            _bakedInputLayout.AddIndexBufferBinding(_indexBuffer);
+
+            renderCounters.UploadedBytes += vertices.size() * sizeof(VertexPositionUv) + localIndicesSize;
+
+            if (benchmarkCase.Strategy == SubmissionStrategy::MultiDrawIndirect)
+            {
+                std::vector<DrawElementsIndirectCommand> drawCommands(benchmarkCase.DrawCount);
+                for (uint32_t objectIndex = 0; objectIndex < benchmarkCase.DrawCount; objectIndex++)
+                {
+                    drawCommands[objectIndex] =
+                    {
+                        .IndexCount = _indicesPerDraw,
+                        .InstanceCount = 1,
+                        .FirstIndex = 0,
+                        .BaseVertex = static_cast<int32_t>(objectIndex * _verticesPerDraw),
+                        .BaseInstance = objectIndex
+                    };
+                }
+
+                glCreateBuffers(1, &_indirectBuffer);
+                glNamedBufferStorage(_indirectBuffer, drawCommands.size() * sizeof(DrawElementsIndirectCommand), drawCommands.data(), 0);
+                renderCounters.UploadedBytes += drawCommands.size() * sizeof(DrawElementsIndirectCommand);
+            }
+            break;
+        }
+        case SubmissionStrategy::Instanced:
+        case SubmissionStrategy::InstancedStorageBuffer:
+        case SubmissionStrategy::BatchedMultiDrawIndirect:
+        case SubmissionStrategy::GpuCulledIndirect:
+        {
+            // no rotation so every strategy draws the same picture, tint and material just vary a bit
+            std::vector<InstanceData> instances(benchmarkCase.DrawCount);
+            for (uint32_t objectIndex = 0; objectIndex < benchmarkCase.DrawCount; objectIndex++)
+            {
+                auto objectOffset = getObjectOffset(objectIndex);
+                auto shade = static_cast<uint8_t>(160 + objectIndex * 37 % 96);
+                instances[objectIndex] =
+                {
+                    .TranslationScale = glm::vec4(objectOffset.x, objectOffset.y, 0.0f, objectSize),
+                    .Rotation = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+                    .Color = { .R = 255, .G = shade, .B = 255, .A = 255 },
+                    .MaterialIndex = objectIndex % 4
+                };
+            }
+
+            glCreateBuffers(1, &_localVertexBuffer);
+            glNamedBufferStorage(_localVertexBuffer, localVertices.size() * sizeof(VertexPositionUv), localVertices.data(), 0);
+            glCreateBuffers(1, &_indexBuffer);
+            glNamedBufferStorage(_indexBuffer, localIndicesSize, localIndices.data(), 0);
+            glCreateBuffers(1, &_instanceBuffer);
+            glNamedBufferStorage(_instanceBuffer, instances.size() * sizeof(InstanceData), instances.data(), 0);
+
+            if (benchmarkCase.Strategy == SubmissionStrategy::InstancedStorageBuffer ||
+                benchmarkCase.Strategy == SubmissionStrategy::GpuCulledIndirect)
+            {
+                // the vertex shader fetches its instance itself, only the mesh goes through the input layout
+                _bakedInputLayout.AddVertexBufferBinding(_localVertexBuffer, 0, 0, sizeof(VertexPositionUv));
+                _bakedInputLayout.AddIndexBufferBinding(_indexBuffer);
+            }
+            else
+            {
+                _instancedInputLayout.AddVertexBufferBinding(_localVertexBuffer, 0, 0, sizeof(VertexPositionUv));
+                _instancedInputLayout.AddVertexBufferBinding(_instanceBuffer, 1, 0, sizeof(InstanceData));
+                _instancedInputLayout.AddIndexBufferBinding(_indexBuffer);
+            }
+
+            renderCounters.UploadedBytes += localVertices.size() * sizeof(VertexPositionUv) + localIndicesSize + instances.size() * sizeof(InstanceData);
+
+            if (benchmarkCase.Strategy == SubmissionStrategy::GpuCulledIndirect)
+            {
+                // every object is the same unit square mesh, its bounds circle the square
+                std::vector<CullingObject> cullingObjects(benchmarkCase.DrawCount,
+                {
+                    .BoundingSphere = glm::vec4(0.5f, 0.5f, 0.0f, 0.70710678f),
+                    .IndexCount = _indicesPerDraw,
+                    .FirstIndex = 0,
+                    .BaseVertex = 0,
+                    .Padding = 0
+                });
+
+                _gpuCulling.SetObjects(cullingObjects);
+                _gpuCulling.ResetStatistics();
+                renderCounters.UploadedBytes += cullingObjects.size() * sizeof(CullingObject);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void DrawBenchmarkApplication::DestroyScene()
+{
+    if (!_objectVertexBuffers.empty())
+    {
+        glDeleteBuffers(static_cast<int32_t>(_objectVertexBuffers.size()), _objectVertexBuffers.data());
+        glDeleteBuffers(static_cast<int32_t>(_objectIndexBuffers.size()), _objectIndexBuffers.data());
+        _objectVertexBuffers.clear();
+        _objectIndexBuffers.clear();
+    }
+
+    auto buffers = std::to_array<uint32_t*>({ &_vertexBuffer, &_localVertexBuffer, &_indexBuffer, &_instanceBuffer, &_indirectBuffer });
+    for (auto buffer : buffers)
+    {
+        if (*buffer != 0)
+        {
+            glDeleteBuffers(1, buffer);
+            *buffer = 0;
+        }
+    }
+
+    // deleting bound buffers unbinds them behind the cache's back and the names get reused
+    stateCache.Invalidate();
+}
+
+void DrawBenchmarkApplication::SubmitDraws()
+{
+    auto& benchmarkCase = _cases[_currentCase];
+    switch (benchmarkCase.Strategy)
+    {
+        case SubmissionStrategy::PerObjectBuffers:
+        {
+            stateCache.BindVertexArray(_bakedInputLayout.Id);
+            stateCache.BindProgramPipeline(_bakedProgram.Id);
+            for (uint32_t objectIndex = 0; objectIndex < benchmarkCase.DrawCount; objectIndex++)
+            {
+                _bakedInputLayout.AddVertexBufferBinding(_objectVertexBuffers[objectIndex], 0, 0, sizeof(VertexPositionUv));
+                _bakedInputLayout.AddIndexBufferBinding(_objectIndexBuffers[objectIndex]);
+                glDrawElements(GL_TRIANGLES, _indicesPerDraw, GL_UNSIGNED_INT, nullptr);
+            }
+
+            renderCounters.DrawCalls += benchmarkCase.DrawCount;
+            break;
+        }
+        case SubmissionStrategy::SharedBuffersBaseVertex:
+        {
+            stateCache.BindVertexArray(_bakedInputLayout.Id);
+            stateCache.BindProgramPipeline(_bakedProgram.Id);
+            for (uint32_t objectIndex = 0; objectIndex < benchmarkCase.DrawCount; objectIndex++)
+            {
+                glDrawElementsBaseVertex(GL_TRIANGLES, _indicesPerDraw, GL_UNSIGNED_INT, nullptr, static_cast<int32_t>(objectIndex * _verticesPerDraw));
+            }
+
+            renderCounters.DrawCalls += benchmarkCase.DrawCount;
+            break;
+        }
+        case SubmissionStrategy::Instanced:
+        {
+            stateCache.BindVertexArray(_instancedInputLayout.Id);
+            stateCache.BindProgramPipeline(_instancedProgram.Id);
+            glDrawElementsInstanced(GL_TRIANGLES, _indicesPerDraw, GL_UNSIGNED_INT, nullptr, benchmarkCase.DrawCount);
+
+            renderCounters.DrawCalls++;
+            break;
+        }
+        case SubmissionStrategy::InstancedStorageBuffer:
+        {
+            auto viewProjection = glm::mat4(1.0f);
+            glProgramUniformMatrix4fv(_instancedStorageProgram.VertexShader, 0, 1, GL_FALSE, glm::value_ptr(viewProjection));
+
+            stateCache.BindVertexArray(_bakedInputLayout.Id);
+            stateCache.BindProgramPipeline(_instancedStorageProgram.Id);
+            stateCache.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _instanceBuffer);
+            glDrawElementsInstanced(GL_TRIANGLES, _indicesPerDraw, GL_UNSIGNED_INT, nullptr, benchmarkCase.DrawCount);
+
+            renderCounters.DrawCalls++;
+            break;
+        }
+        case SubmissionStrategy::MultiDrawIndirect:
+        {
+            stateCache.BindVertexArray(_bakedInputLayout.Id);
+            stateCache.BindProgramPipeline(_bakedProgram.Id);
+            stateCache.BindBuffer(GL_DRAW_INDIRECT_BUFFER, _indirectBuffer);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, benchmarkCase.DrawCount, 0);
+
+            renderCounters.DrawCalls++;
+            break;
+        }
+        case SubmissionStrategy::BatchedMultiDrawIndirect:
+        {
+            // every object is its own draw, its transform comes from the instance attributes at BaseInstance
+            MeshAllocation localMesh = { .BaseVertex = 0, .VertexCount = _verticesPerDraw, .FirstIndex = 0, .IndexCount = _indicesPerDraw };
+
+            _drawBatcher.BeginFrame();
+            for (uint32_t objectIndex = 0; objectIndex < benchmarkCase.DrawCount; objectIndex++)
+            {
+                _drawBatcher.Add(_instancedInputLayout, _instancedProgram, localMesh, objectIndex);
+            }
+
+            _drawBatcher.Submit(stateCache, GL_TRIANGLES);
+            _drawBatcher.EndFrame();
+
+            renderCounters.DrawCalls += _drawBatcher.GetStatistics().BatchCount;
+            break;
+        }
+        case SubmissionStrategy::GpuCulledIndirect:
+        {
+            // zoomed in on the middle of the scene, so the objects around it have something to be culled by
+            auto viewProjection = glm::scale(glm::mat4(1.0f), glm::vec3(2.0f, 2.0f, 1.0f));
+            _gpuCulling.Cull(stateCache, _cullProgram, _instanceBuffer, GpuCulling::ExtractFrustumPlanes(viewProjection));
+
+            glProgramUniformMatrix4fv(_instancedStorageProgram.VertexShader, 0, 1, GL_FALSE, glm::value_ptr(viewProjection));
+
+            // every surviving command has an InstanceCount of 1 and its object index as BaseInstance
+            stateCache.BindVertexArray(_bakedInputLayout.Id);
+            stateCache.BindProgramPipeline(_instancedStorageProgram.Id);
+            stateCache.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _instanceBuffer);
+            _gpuCulling.Draw(stateCache, GL_TRIANGLES);
+
+            renderCounters.DrawCalls++;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void DrawBenchmarkApplication::FinishCase()
+{
+    auto& benchmarkCase = _cases[_currentCase];
+
+    // the culling counts arrive a few frames late, averaging them over whatever did arrive is plenty
+    auto visibleObjectCount = static_cast<double>(benchmarkCase.DrawCount);
+    auto culledObjectCount = 0.0;
+    auto& cullingStatistics = _gpuCulling.GetStatistics();
+    if (benchmarkCase.Strategy == SubmissionStrategy::GpuCulledIndirect && cullingStatistics.ReadbackCount > 0)
+    {
+        visibleObjectCount = static_cast<double>(cullingStatistics.VisibleCount) / static_cast<double>(cullingStatistics.ReadbackCount);
+        culledObjectCount = static_cast<double>(cullingStatistics.CulledCount) / static_cast<double>(cullingStatistics.ReadbackCount);
+    }
+
+    DrawBenchmarkResult result =
+    {
+        .Case = benchmarkCase,
+        .TrianglesPerDraw = _trianglesPerDraw,
+        .SubmissionTime = _submissionTimes.GetSummary(),
+        .FrameTime = _frameTimes.GetSummary(),
+        .VisibleObjectCount = visibleObjectCount,
+        .CulledObjectCount = culledObjectCount
+    };
+    _results.push_back(result);
+
+    _submissionTimes.Clear();
+    _frameTimes.Clear();
+
+    spdlog::info("Bench: {:<24} {:>8} triangles {:>7} draws: submission p50 {:.3f}ms p99 {:.3f}ms, frame p50 {:.3f}ms p99 {:.3f}ms",
+        GetSubmissionStrategyName(benchmarkCase.Strategy),
+        benchmarkCase.TriangleCount,
+        benchmarkCase.DrawCount,
+        result.SubmissionTime.P50,
+        result.SubmissionTime.P99,
+        result.FrameTime.P50,
+        result.FrameTime.P99);
+
+    if (benchmarkCase.Strategy == SubmissionStrategy::GpuCulledIndirect)
+    {
+        spdlog::info("Bench: {:<24} {:.0f} visible and {:.0f} culled objects per frame, {} readbacks dropped",
+            GetSubmissionStrategyName(benchmarkCase.Strategy),
+            result.VisibleObjectCount,
+            result.CulledObjectCount,
+            cullingStatistics.DroppedReadbackCount);
+    }
+}
+
+void DrawBenchmarkApplication::AdvanceCase()
+{
+    FinishCase();
+    DestroyScene();
+
+    _currentCase++;
+    _currentFrame = 0;
+
+    if (_currentCase < _cases.size())
+    {
+        CreateScene(_cases[_currentCase]);
+    }
+    else
+    {
+        WriteResults();
+        Close();
+    }
+}
+
+bool DrawBenchmarkApplication::WriteResults() const
+{
+    std::ofstream file(_benchmarkSettings.OutputFilePath, std::ios::trunc);
+    if (!file.is_open())
+    {
+        spdlog::error("Bench: Unable to open {} for writing", _benchmarkSettings.OutputFilePath);
+        return false;
+    }
+
+    auto isCsv = std::string_view(_benchmarkSettings.OutputFilePath).ends_with(".csv");
+    if (isCsv)
+    {
+        file << "strategy,triangles,draws,triangles_per_draw,frames,"
+                "submission_mean_ms,submission_p50_ms,submission_p95_ms,submission_p99_ms,submission_max_ms,"
+                "frame_mean_ms,frame_p50_ms,frame_p95_ms,frame_p99_ms,frame_max_ms,"
+                "visible_objects,culled_objects\n";
+    }
+    else
+    {
+        file << "[";
+    }
+
+    auto formatSummaryCsv = [](const HistogramSummary& summary)
+    {
+        return std::format("{:.6f},{:.6f},{:.6f},{:.6f},{:.6f}", summary.Mean, summary.P50, summary.P95, summary.P99, summary.Max);
+    };
+    auto formatSummaryJson = [](const HistogramSummary& summary)
+    {
+        return std::format("{{ \"mean\": {:.6f}, \"p50\": {:.6f}, \"p95\": {:.6f}, \"p99\": {:.6f}, \"max\": {:.6f} }}", summary.Mean, summary.P50, summary.P95, summary.P99, summary.Max);
+    };
+
+    for (size_t resultIndex = 0; resultIndex < _results.size(); resultIndex++)
+    {
+        auto& result = _results[resultIndex];
+        if (isCsv)
+        {
+            file << std::format("{},{},{},{},{},{},{},{:.1f},{:.1f}\n",
+                GetSubmissionStrategyName(result.Case.Strategy),
+                result.Case.TriangleCount,
+                result.Case.DrawCount,
+                result.TrianglesPerDraw,
+                result.FrameTime.Count,
+                formatSummaryCsv(result.SubmissionTime),
+                formatSummaryCsv(result.FrameTime),
+                result.VisibleObjectCount,
+                result.CulledObjectCount);
+        }
+        else
+        {
+            file << std::format("{}\n  {{ \"strategy\": \"{}\", \"triangles\": {}, \"draws\": {}, \"trianglesPerDraw\": {}, \"frames\": {}, \"submissionMs\": {}, \"frameMs\": {}, \"visibleObjects\": {:.1f}, \"culledObjects\": {:.1f} }}",
+                resultIndex == 0 ? "" : ",",
+                GetSubmissionStrategyName(result.Case.Strategy),
+                result.Case.TriangleCount,
+                result.Case.DrawCount,
+                result.TrianglesPerDraw,
+                result.FrameTime.Count,
+                formatSummaryJson(result.SubmissionTime),
+                formatSummaryJson(result.FrameTime),
+                result.VisibleObjectCount,
+                result.CulledObjectCount);
+        }
+    }
+
+    if (!isCsv)
+    {
+        file << "\n]\n";
+    }
+
+    spdlog::info("Bench: Results written to {}", _benchmarkSettings.OutputFilePath);
+    return true;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "../src/Shared/Application.hpp"
+#include "../src/Shared/DrawBatcher.hpp"
+#include "../src/Shared/FrameStatistics.hpp"
+#include "../src/Shared/GpuCulling.hpp"
+#include "../src/Shared/InputLayout.hpp"
+#include "../src/Shared/Program.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class SubmissionStrategy : uint32_t
+{
+    PerObjectBuffers,
+    SharedBuffersBaseVertex,
+    Instanced,
+    InstancedStorageBuffer,
+    MultiDrawIndirect,
+    BatchedMultiDrawIndirect,
+    GpuCulledIndirect,
+    Count
+};
+
+std::string_view GetSubmissionStrategyName(SubmissionStrategy strategy);
+
+struct DrawBenchmarkSettings
+{
+    std::vector<uint32_t> TriangleCounts = { 1, 1'000, 100'000, 1'000'000 };
+    std::vector<uint32_t> DrawCounts = { 1, 100, 10'000, 100'000 };
+    std::vector<SubmissionStrategy> Strategies =
+    {
+        SubmissionStrategy::PerObjectBuffers,
+        SubmissionStrategy::SharedBuffersBaseVertex,
+        SubmissionStrategy::Instanced,
+        SubmissionStrategy::InstancedStorageBuffer,
+        SubmissionStrategy::MultiDrawIndirect,
+        SubmissionStrategy::BatchedMultiDrawIndirect,
+        SubmissionStrategy::GpuCulledIndirect
+    };
+    uint32_t WarmupFrameCount = 10;
+    uint32_t MeasuredFrameCount = 100;
+    std::string OutputFilePath = "DrawBenchmark.json";
+};
+
+struct DrawBenchmarkCase
+{
+    SubmissionStrategy Strategy;
+    uint32_t TriangleCount;
+    uint32_t DrawCount;
+};
+
+struct DrawBenchmarkResult
+{
+    DrawBenchmarkCase Case;
+    uint32_t TrianglesPerDraw;
+    HistogramSummary SubmissionTime;
+    HistogramSummary FrameTime;
+    // per frame averages, only GpuCulledIndirect culls anything
+    double VisibleObjectCount;
+    double CulledObjectCount;
+};
+
+class DrawBenchmarkApplication final : public Application
+{
+public:
+    explicit DrawBenchmarkApplication(DrawBenchmarkSettings benchmarkSettings);
+
+protected:
+    bool Load() override;
+    void Unload() override;
+    void Render() override;
+    void OnProgramReloaded(const Program& program) override;
+
+private:
+    bool IsStrategyRequested(SubmissionStrategy strategy) const;
+    // removes the strategy before the cases are built, warns once when it was requested
+    void DropStrategy(
+        SubmissionStrategy strategy,
+        std::string_view reason);
+
+    void CreateScene(const DrawBenchmarkCase& benchmarkCase);
+    void DestroyScene();
+    void SubmitDraws();
+    void FinishCase();
+    void AdvanceCase();
+    bool WriteResults() const;
+
+    DrawBenchmarkSettings _benchmarkSettings;
+    std::vector<DrawBenchmarkCase> _cases;
+    std::vector<DrawBenchmarkResult> _results;
+    size_t _currentCase = 0;
+    uint32_t _currentFrame = 0;
+
+    Program _bakedProgram;
+    Program _instancedProgram;
+    Program _instancedStorageProgram;
+    Program _cullProgram;
+    InputLayout _bakedInputLayout;
+    InputLayout _instancedInputLayout;
+
+    uint32_t _trianglesPerDraw = 0;
+    uint32_t _verticesPerDraw = 0;
+    uint32_t _indicesPerDraw = 0;
+    std::vector<uint32_t> _objectVertexBuffers;
+    std::vector<uint32_t> _objectIndexBuffers;
+    uint32_t _vertexBuffer = 0;
+    uint32_t _localVertexBuffer = 0;
+    uint32_t _indexBuffer = 0;
+    uint32_t _instanceBuffer = 0;
+    uint32_t _indirectBuffer = 0;
+
+    DrawBatcher _drawBatcher;
+    GpuCulling _gpuCulling;
+
+    RollingHistogram _submissionTimes;
+    RollingHistogram _frameTimes;
+};
@@ -0,0 +1,126 @@
+#include "DrawBenchmarkApplication.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <charconv>
+#include <optional>
+
+static std::optional<std::vector<uint32_t>> ParseCounts(std::string_view text)
+{
+    std::vector<uint32_t> counts;
+    while (!text.empty())
+    {
+        auto separator = text.find(',');
+        auto countText = text.substr(0, separator);
+
+        uint32_t count = 0;
+        auto [_, errorCode] = std::from_chars(countText.data(), countText.data() + countText.size(), count);
+        if (errorCode != std::errc())
+        {
+            return std::nullopt;
+        }
+
+        counts.push_back(count);
+        text = separator == std::string_view::npos ? std::string_view() : text.substr(separator + 1);
+    }
+
+    return counts;
+}
+
+static std::optional<std::vector<SubmissionStrategy>> ParseStrategies(std::string_view text)
+{
+    std::vector<SubmissionStrategy> strategies;
+    while (!text.empty())
+    {
+        auto separator = text.find(',');
+        auto strategyName = text.substr(0, separator);
+
+        auto isKnownStrategy = false;
+        for (uint32_t strategyIndex = 0; strategyIndex < static_cast<uint32_t>(SubmissionStrategy::Count); strategyIndex++)
+        {
+            auto strategy = static_cast<SubmissionStrategy>(strategyIndex);
+            if (GetSubmissionStrategyName(strategy) == strategyName)
+            {
+                strategies.push_back(strategy);
+                isKnownStrategy = true;
+            }
+        }
+
+        if (!isKnownStrategy)
+        {
+            return std::nullopt;
+        }
+
+        text = separator == std::string_view::npos ? std::string_view() : text.substr(separator + 1);
+    }
+
+    return strategies;
+}
+
+static void PrintUsage()
+{
+    spdlog::info("Usage: DrawBenchmark [--triangles=1,1000,...] [--draws=1,100,...] [--strategies=Name,...] [--warmup=N] [--frames=N] [--output=file.json|file.csv]");
+    for (uint32_t strategyIndex = 0; strategyIndex < static_cast<uint32_t>(SubmissionStrategy::Count); strategyIndex++)
+    {
+        spdlog::info("  strategy {}", GetSubmissionStrategyName(static_cast<SubmissionStrategy>(strategyIndex)));
+    }
+}
+
+int32_t main(
+    int32_t argc,
+    char* argv[])
+{
+    DrawBenchmarkSettings benchmarkSettings;
+
+    for (int32_t argumentIndex = 1; argumentIndex < argc; argumentIndex++)
+    {
+        std::string_view argument = argv[argumentIndex];
+        auto separator = argument.find('=');
+        auto name = argument.substr(0, separator);
+        auto value = separator == std::string_view::npos ? std::string_view() : argument.substr(separator + 1);
+
+        std::optional<std::vector<uint32_t>> counts;
+        if (name == "--triangles" && (counts = ParseCounts(value)))
+        {
+            benchmarkSettings.TriangleCounts = counts.value();
+        }
+        else if (name == "--draws" && (counts = ParseCounts(value)))
+        {
+            benchmarkSettings.DrawCounts = counts.value();
+        }
+        else if (name == "--warmup" && (counts = ParseCounts(value)) && counts->size() == 1)
+        {
+            benchmarkSettings.WarmupFrameCount = counts->front();
+        }
+        else if (name == "--frames" && (counts = ParseCounts(value)) && counts->size() == 1)
+        {
+            benchmarkSettings.MeasuredFrameCount = counts->front();
+        }
+        else if (name == "--strategies")
+        {
+            auto strategies = ParseStrategies(value);
+            if (!strategies.has_value())
+            {
+                spdlog::error("Bench: Unknown strategy in {}", value);
+                PrintUsage();
+                return 1;
+            }
+
+            benchmarkSettings.Strategies = strategies.value();
+        }
+        else if (name == "--output" && !value.empty())
+        {
+            benchmarkSettings.OutputFilePath = value;
+        }
+        else
+        {
+            spdlog::error("Bench: Invalid argument {}", argument);
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    DrawBenchmarkApplication application(benchmarkSettings);
+    application.Run();
+    return 0;
+}
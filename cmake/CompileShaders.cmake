@@ -0,0 +1,46 @@
+find_program(GLSLANG_VALIDATOR glslangValidator HINTS $ENV{VULKAN_SDK}/bin $ENV{VULKAN_SDK}/Bin)
+
+# Compiles the target's Data/Shaders/*.<stage>.glsl to OpenGL SPIR-V, written as <file>.glsl.spv next to
+# what the POST_BUILD copy_directory puts into the build directory. Files in Data/Shaders/Include are
+# only pulled in through #include. Without glslangValidator the application loads the GLSL text.
+function(target_compile_shaders target)
+    if (NOT GLSLANG_VALIDATOR)
+        message(STATUS "glslangValidator not found, ${target} compiles its shaders from GLSL at runtime")
+        return()
+    endif()
+
+    set(sourceDirectory ${CMAKE_CURRENT_SOURCE_DIR}/Data/Shaders)
+    set(outputDirectory ${CMAKE_CURRENT_BINARY_DIR}/Data/Shaders)
+    file(GLOB shaderFiles CONFIGURE_DEPENDS ${sourceDirectory}/*.glsl)
+    file(GLOB_RECURSE includeFiles CONFIGURE_DEPENDS ${sourceDirectory}/Include/*.glsl)
+
+    set(spirvFiles)
+    foreach(shaderFile ${shaderFiles})
+        get_filename_component(shaderFileName ${shaderFile} NAME)
+        if (shaderFileName MATCHES "\\.vs\\.glsl$")
+            set(shaderStage vert)
+        elseif (shaderFileName MATCHES "\\.fs\\.glsl$")
+            set(shaderStage frag)
+        elseif (shaderFileName MATCHES "\\.gs\\.glsl$")
+            set(shaderStage geom)
+        elseif (shaderFileName MATCHES "\\.cs\\.glsl$")
+            set(shaderStage comp)
+        else()
+            continue()
+        endif()
+
+        set(spirvFile ${outputDirectory}/${shaderFileName}.spv)
+        add_custom_command(
+            OUTPUT ${spirvFile}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${outputDirectory}
+            COMMAND ${GLSLANG_VALIDATOR} -G -S ${shaderStage} -o ${spirvFile} ${shaderFile}
+            DEPENDS ${shaderFile} ${includeFiles}
+            COMMENT "Compiling ${shaderFileName} to SPIR-V"
+            VERBATIM
+        )
+        list(APPEND spirvFiles ${spirvFile})
+    endforeach()
+
+    add_custom_target(${target}Shaders DEPENDS ${spirvFiles})
+    add_dependencies(${target} ${target}Shaders)
+endfunction()
@@ -0,0 +1,30 @@
+# Converts the target's Data/Meshes/*.obj|gltf|glb into <name>.mesh in the build's Data/Meshes,
+# in the vertex format given by VERTEX_FORMAT (PositionUv by default).
+function(target_convert_meshes target)
+    cmake_parse_arguments(PARSE_ARGV 1 MESHES "" "VERTEX_FORMAT" "")
+    if (NOT MESHES_VERTEX_FORMAT)
+        set(MESHES_VERTEX_FORMAT PositionUv)
+    endif()
+
+    set(sourceDirectory ${CMAKE_CURRENT_SOURCE_DIR}/Data/Meshes)
+    set(outputDirectory ${CMAKE_CURRENT_BINARY_DIR}/Data/Meshes)
+    file(GLOB sourceFiles CONFIGURE_DEPENDS ${sourceDirectory}/*.obj ${sourceDirectory}/*.gltf ${sourceDirectory}/*.glb)
+
+    set(meshFiles)
+    foreach(sourceFile ${sourceFiles})
+        get_filename_component(meshName ${sourceFile} NAME_WLE)
+        set(meshFile ${outputDirectory}/${meshName}.mesh)
+        add_custom_command(
+            OUTPUT ${meshFile}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${outputDirectory}
+            COMMAND $<TARGET_FILE:MeshConverter> ${sourceFile} ${meshFile} --format=${MESHES_VERTEX_FORMAT}
+            DEPENDS ${sourceFile} MeshConverter
+            COMMENT "Converting ${meshName} to a mesh file"
+            VERBATIM
+        )
+        list(APPEND meshFiles ${meshFile})
+    endforeach()
+
+    add_custom_target(${target}Meshes DEPENDS ${meshFiles})
+    add_dependencies(${target} ${target}Meshes)
+endfunction()
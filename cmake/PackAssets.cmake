@@ -0,0 +1,11 @@
+# Packs the target's Data/ folder in the build directory into Data.pack next to it. Runs POST_BUILD,
+# so call it after the copy_directory step, and picks up the SPIR-V from target_compile_shaders as well.
+function(target_pack_assets target)
+    add_dependencies(${target} AssetPacker)
+    add_custom_command(
+        TARGET ${target}
+        POST_BUILD
+        COMMAND $<TARGET_FILE:AssetPacker> ${CMAKE_CURRENT_BINARY_DIR}/Data ${CMAKE_CURRENT_BINARY_DIR}/Data.pack
+        VERBATIM
+    )
+endfunction()
@@ -2,8 +2,8 @@
 
 #include <spdlog/spdlog.h>
 
-void HelloWindowApplication::Update()
+void HelloWindowApplication::Update(float deltaTime)
 {
-    Application::Update();
+    Application::Update(deltaTime);
     spdlog::info("Hello from HelloWindowApplication");
 }
\ No newline at end of file
@@ -5,5 +5,5 @@
 class HelloWindowApplication final : public Application
 {
 protected:
-    void Update() override;
+    void Update(float deltaTime) override;
 };
\ No newline at end of file
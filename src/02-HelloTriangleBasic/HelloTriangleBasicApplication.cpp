@@ -1,5 +1,6 @@
 #include "HelloTriangleBasicApplication.hpp"
-#include "VertexPositionColor.hpp"
+#include "../Shared/VertexLayout.hpp"
+#include "../Shared/VertexPositionColor.hpp"
 
 #include <glad/glad.h>
 #include <spdlog/spdlog.h>
@@ -81,13 +82,13 @@ bool HelloTriangleBasicApplication::Load()
     label = "InputLayout_Simple";
     glObjectLabel(GL_VERTEX_ARRAY, _inputLayout, label.size(), label.data());
 
-    glEnableVertexArrayAttrib(_inputLayout, 0);
-    glVertexArrayAttribFormat(_inputLayout, 0, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPositionColor, Position));
-    glVertexArrayAttribBinding(_inputLayout, 0, 0);
-
-    glEnableVertexArrayAttrib(_inputLayout, 1);
-    glVertexArrayAttribFormat(_inputLayout, 1, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPositionColor, Color));
-    glVertexArrayAttribBinding(_inputLayout, 1, 0);
+    // one attribute per member of VertexPositionColor, worked out at compile time
+    for (auto& element : VertexTraits<VertexPositionColor>::Elements)
+    {
+        glEnableVertexArrayAttrib(_inputLayout, element.AttributeIndex);
+        glVertexArrayAttribFormat(_inputLayout, element.AttributeIndex, element.ComponentCount, element.ComponentType, element.IsNormalized, element.Offset);
+        glVertexArrayAttribBinding(_inputLayout, element.AttributeIndex, element.BindingIndex);
+    }
 
     std::array<VertexPositionColor, 3> vertices =
     {
@@ -113,7 +114,7 @@ bool HelloTriangleBasicApplication::Load()
     glObjectLabel(GL_BUFFER, _vertexBuffer, label.size(), label.data());
     glNamedBufferData(_indexBuffer, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
 
-    glVertexArrayVertexBuffer(_inputLayout, 0, _vertexBuffer, 0, sizeof(VertexPositionColor));
+    glVertexArrayVertexBuffer(_inputLayout, 0, _vertexBuffer, 0, VertexTraits<VertexPositionColor>::Stride);
     glVertexArrayElementBuffer(_inputLayout, _indexBuffer);
 
     glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
@@ -4,7 +4,9 @@ layout(location = 0) in vec2 v_uv;
 
 layout(location = 0) out vec4 o_color;
 
+layout(binding = 0) uniform sampler2D s_albedo;
+
 void main()
 {
-    o_color = vec4(v_uv, 0.0f, 1.0f);
+    o_color = texture(s_albedo, v_uv);
 }
\ No newline at end of file
@@ -3,7 +3,11 @@
 layout(location = 0) in vec3 i_position;
 layout(location = 1) in vec2 i_uv;
 
-layout (location = 0) out gl_PerVertex
+// from the mesh header, position = offset + scale * snorm16 position
+layout(location = 0) uniform vec3 u_positionOffset;
+layout(location = 1) uniform vec3 u_positionScale;
+
+out gl_PerVertex
 {
     vec4 gl_Position;
 };
@@ -11,6 +15,6 @@ layout(location = 0) out vec2 v_uv;
 
 void main()
 {
-    gl_Position = vec4(i_position, 1.0);
+    gl_Position = vec4(u_positionOffset + u_positionScale * i_position, 1.0);
     v_uv = i_uv;
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "HelloTriangleApplication.hpp"
+#include "../Shared/Profiling.hpp"
+#include "../Shared/VertexLayout.hpp"
 
 #include <glad/glad.h>
 #include <spdlog/spdlog.h>
@@ -24,135 +26,96 @@ bool HelloTriangleApplication::Load()
 
     _simpleProgram = createProgramResult.value();
 
-    _inputLayout = CreateInputLayout("PositionUv", std::to_array<const InputLayoutElement>(
+    _inputLayout = CreateInputLayout("PositionUvQuantized", VertexTraits<VertexPositionUvQuantized>::Elements);
+
+    if (!_geometryArena.Initialize("PositionUvQuantized", sizeof(VertexPositionUvQuantized), 1 << 16, 1 << 18))
     {
-        { .AttributeIndex = 0, .ComponentCount = 3, .ComponentType = GL_FLOAT, .IsNormalized = GL_FALSE, .Offset = offsetof(VertexPositionUv, Position), .BindingIndex = 0 },
-        { .AttributeIndex = 1, .ComponentCount = 2, .ComponentType = GL_FLOAT, .IsNormalized = GL_FALSE, .Offset = offsetof(VertexPositionUv, Uv), .BindingIndex = 0 },
-    }));
+        return false;
+    }
 
-    _vertices.push_back({.Position = glm::vec3(-0.5f, +0.5f, 0.0f), .Uv = glm::vec2(0.0f, 1.0f)});
-    _vertices.push_back({.Position = glm::vec3(+0.5f, +0.5f, 0.0f), .Uv = glm::vec2(1.0f, 1.0f)});
-    _vertices.push_back({.Position = glm::vec3(+0.0f, -0.5f, 0.0f), .Uv = glm::vec2(0.5f, 0.0f)});
+    // built from Data/Meshes/Triangle.obj by MeshConverter, uploaded straight from the mapping
+    MeshFile triangleMeshFile;
+    auto openResult = triangleMeshFile.Open("Data/Meshes/Triangle.mesh", &GetAssetPack());
+    if (!openResult.has_value())
+    {
+        spdlog::error("Loading Mesh {} failed. {}", "Triangle", openResult.error());
+        return false;
+    }
 
-    glCreateBuffers(1, &_vertexBuffer);
-    glNamedBufferData(_vertexBuffer, _vertices.size() * sizeof(VertexPositionUv), _vertices.data(), GL_STATIC_DRAW);
+    auto& triangleMeshHeader = triangleMeshFile.GetHeader();
+    if (triangleMeshHeader.VertexFormat != MeshVertexFormat::PositionUvQuantized)
+    {
+        spdlog::error("Loading Mesh {} failed. It is not made of VertexPositionUvQuantized", "Triangle");
+        return false;
+    }
 
-    _indices.push_back(0);
-    _indices.push_back(1);
-    _indices.push_back(2);
+    auto& positionOffset = triangleMeshHeader.PositionOffset;
+    auto& positionScale = triangleMeshHeader.PositionScale;
+    _positionOffset = glm::vec3(positionOffset[0], positionOffset[1], positionOffset[2]);
+    _positionScale = glm::vec3(positionScale[0], positionScale[1], positionScale[2]);
+    SetPositionDequantization();
+
+    std::vector<uint32_t> indexStorage;
+    auto vertexData = triangleMeshFile.GetVertexData();
+    auto indices = triangleMeshFile.GetIndices(indexStorage);
+    auto triangleMesh = _geometryArena.Allocate(vertexData, indices);
+    if (!triangleMesh.has_value())
+    {
+        return false;
+    }
 
-    glCreateBuffers(1, &_indexBuffer);
-    glNamedBufferData(_indexBuffer, _indices.size() * sizeof(uint32_t), _indices.data(), GL_STATIC_DRAW);
+    _triangleMesh = triangleMesh.value();
+    renderCounters.UploadedBytes += vertexData.size() + indices.size_bytes();
 
-    _inputLayout.AddVertexBufferBinding(_vertexBuffer, 0, 0, sizeof(VertexPositionUv));
-    _inputLayout.AddIndexBufferBinding(_indexBuffer);
+    _geometryArena.Bind(_inputLayout);
 
-    glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+    // decoded on the job system and uploaded later, until then the handle samples the placeholder
+    _checkerTexture = GetAssetLoader().LoadTexture("Data/Textures/Checker.png");
+
+    stateCache.SetClearColor(0.05f, 0.05f, 0.05f, 1.0f);
 
     return true;
 }
 
 void HelloTriangleApplication::Unload()
 {
-    glDeleteProgram(_simpleProgram.VertexShader);
-    glDeleteProgram(_simpleProgram.FragmentShader);
-    glDeleteProgramPipelines(1, &_simpleProgram.Id);
+    DeleteProgram(_simpleProgram);
+    _geometryArena.Destroy();
     Application::Unload();
 }
 
-void HelloTriangleApplication::Render()
+void HelloTriangleApplication::OnProgramReloaded(const Program& program)
 {
-    Application::Render();
-
-    _inputLayout.Bind();
-    glBindProgramPipeline(_simpleProgram.Id);
-
-    glDrawElements(GL_TRIANGLES, _indices.size(), GL_UNSIGNED_INT, nullptr);
-}
-
-std::expected<uint32_t, std::string> HelloTriangleApplication::CreateShaderProgram(
-        std::string_view label,
-        uint32_t shaderType,
-        std::string_view shaderSource)
-{
-    auto shaderContent = shaderSource.data();
-    auto shaderProgram = glCreateShaderProgramv(shaderType, 1, &shaderContent);
-    glProgramParameteri(shaderProgram, GL_PROGRAM_SEPARABLE, GL_TRUE);
-    auto linkStatus = 0;
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &linkStatus);
-
-    if (linkStatus == GL_FALSE)
+    if (program.Id == _simpleProgram.Id)
     {
-        auto infoLogLength = 0;
-        char infoLog[1024];
-        glGetProgramInfoLog(shaderProgram, 1024, &infoLogLength, infoLog);
-
-        return std::unexpected(infoLog);
+        _simpleProgram = program;
+        SetPositionDequantization();
     }
-
-    glObjectLabel(GL_PROGRAM, shaderProgram, label.size(), label.data());
-
-    return shaderProgram;
 }
 
-std::expected<Program, std::string> HelloTriangleApplication::CreateProgram(
-    std::string_view label,
-    const std::string& vertexShaderFilePath,
-    const std::string& fragmentShaderFilePath)
+void HelloTriangleApplication::SetPositionDequantization()
 {
-    auto vertexShaderFileContent = ReadTextFromFile(vertexShaderFilePath.data());
-    if (!vertexShaderFileContent.has_value())
-    {
-        return std::unexpected(vertexShaderFileContent.error());
-    }
-
-    auto fragmentShaderFileContent = ReadTextFromFile(fragmentShaderFilePath.data());
-    if (!fragmentShaderFileContent.has_value())
-    {
-        return std::unexpected(fragmentShaderFileContent.error());
-    }
-
-    Program program = {};
-
-    auto vertexShaderProgram = CreateShaderProgram(std::format("VS_{}", label), GL_VERTEX_SHADER, vertexShaderFileContent.value());
-    if (!vertexShaderProgram.has_value())
-    {
-        return std::unexpected(vertexShaderProgram.error());
-    }
-
-    program.VertexShader = vertexShaderProgram.value();
-
-    auto fragmentShaderProgram = CreateShaderProgram(std::format("FS_{}", label), GL_FRAGMENT_SHADER, fragmentShaderFileContent.value());
-    if (!fragmentShaderProgram.has_value())
-    {
-        return std::unexpected(fragmentShaderProgram.error());
-    }
-
-    program.FragmentShader = fragmentShaderProgram.value();
-
-    glCreateProgramPipelines(1, &program.Id);
-
-    glUseProgramStages(program.Id, GL_VERTEX_SHADER_BIT, program.VertexShader);
-    glUseProgramStages(program.Id, GL_FRAGMENT_SHADER_BIT, program.FragmentShader);
-
-    return program;
+    // the snorm16 positions decode to [-1, 1], the vertex shader maps them back onto the bounds
+    glProgramUniform3fv(_simpleProgram.VertexShader, 0, 1, &_positionOffset.x);
+    glProgramUniform3fv(_simpleProgram.VertexShader, 1, 1, &_positionScale.x);
 }
 
-InputLayout HelloTriangleApplication::CreateInputLayout(
-    std::string_view label,
-    std::span<const InputLayoutElement> elements)
+void HelloTriangleApplication::Render()
 {
-    InputLayout inputLayout = {};
-    inputLayout.Label = label;
-    glCreateVertexArrays(1, &inputLayout.Id);
-    glObjectLabel(GL_VERTEX_ARRAY, inputLayout.Id, label.size(), label.data());
+    Application::Render();
 
-    for(auto& element : elements)
-    {
-        glEnableVertexArrayAttrib(inputLayout.Id, element.AttributeIndex);
-        glVertexArrayAttribFormat(inputLayout.Id, element.AttributeIndex, element.ComponentCount, element.ComponentType, element.IsNormalized, element.Offset);
-        glVertexArrayAttribBinding(inputLayout.Id, element.AttributeIndex, element.BindingIndex);
-    }
+    TracyGpuZone("HelloTriangle");
+
+    stateCache.BindVertexArray(_inputLayout.Id);
+    stateCache.BindProgramPipeline(_simpleProgram.Id);
+    stateCache.BindTextureUnit(0, GetAssetLoader().GetTexture(_checkerTexture));
 
-    return inputLayout;
+    auto& triangleMesh = _geometryArena.GetMesh(_triangleMesh);
+    glDrawElementsBaseVertex(
+        GL_TRIANGLES,
+        triangleMesh.IndexCount,
+        GL_UNSIGNED_INT,
+        reinterpret_cast<const void*>(triangleMesh.FirstIndex * sizeof(uint32_t)),
+        triangleMesh.BaseVertex);
+    renderCounters.DrawCalls++;
 }
@@ -1,15 +1,16 @@
 #pragma once
 
 #include "../Shared/Application.hpp"
-#include "VertexPositionUv.hpp"
-#include "Program.hpp"
-#include "InputLayout.hpp"
+#include "../Shared/AssetLoader.hpp"
+#include "../Shared/BufferArena.hpp"
+#include "../Shared/VertexPositionUvQuantized.hpp"
+#include "../Shared/Program.hpp"
+#include "../Shared/InputLayout.hpp"
+#include "../Shared/MeshFile.hpp"
+
+#include <glm/vec3.hpp>
 
 #include <vector>
-#include <string>
-#include <string_view>
-#include <expected>
-#include <span>
 
 class HelloTriangleApplication final : public Application
 {
@@ -17,25 +18,18 @@ protected:
     bool Load() override;
     void Unload() override;
     void Render() override;
+    void OnProgramReloaded(const Program& program) override;
 
 private:
-    std::expected<uint32_t, std::string> CreateShaderProgram(
-        std::string_view label,
-        uint32_t shaderType,
-        std::string_view shaderSource);
-    std::expected<Program, std::string> CreateProgram(
-        std::string_view label,
-        const std::string& vertexShaderFilePath,
-        const std::string& fragmentShaderFilePath);
-    InputLayout CreateInputLayout(
-        std::string_view label,
-        std::span<const InputLayoutElement> elements);
+    void SetPositionDequantization();
 
     InputLayout _inputLayout;
-    uint32_t _vertexBuffer = 0;
-    uint32_t _indexBuffer = 0;
-    std::vector<VertexPositionUv> _vertices;
-    std::vector<uint32_t> _indices;
+    BufferArena _geometryArena;
+    MeshHandle _triangleMesh;
+    TextureHandle _checkerTexture;
+    // from the triangle's mesh header, the vertex shader turns snorm16 positions back into these bounds
+    glm::vec3 _positionOffset = glm::vec3(0.0f);
+    glm::vec3 _positionScale = glm::vec3(1.0f);
 
     Program _simpleProgram;
 };
\ No newline at end of file
@@ -1,10 +0,0 @@
-#pragma once
-
-#include <cstdint>
-
-struct Program
-{
-    uint32_t Id = 0;
-    uint32_t VertexShader = 0;
-    uint32_t FragmentShader = 0;
-};
\ No newline at end of file
@@ -1,13 +1,68 @@
 #include "Application.hpp"
+#include "Profiling.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <spdlog/spdlog.h>
 
 #include <debugbreak.h>
+#include <stb_image_write.h>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
 #include <format>
 #include <fstream>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+struct ShaderStage
+{
+    uint32_t ShaderType;
+    uint32_t StageBit;
+    std::string_view LabelPrefix;
+    std::string ProgramDescription::* FilePath;
+    uint32_t Program::* ShaderProgram;
+};
+
+// a program uses the stages its description has a file for
+static constexpr auto ShaderStages = std::to_array<ShaderStage>(
+{
+    { GL_VERTEX_SHADER, GL_VERTEX_SHADER_BIT, "VS", &ProgramDescription::VertexShaderFilePath, &Program::VertexShader },
+    { GL_FRAGMENT_SHADER, GL_FRAGMENT_SHADER_BIT, "FS", &ProgramDescription::FragmentShaderFilePath, &Program::FragmentShader },
+    { GL_COMPUTE_SHADER, GL_COMPUTE_SHADER_BIT, "CS", &ProgramDescription::ComputeShaderFilePath, &Program::ComputeShader },
+});
+
+static const ShaderStage& GetShaderStage(uint32_t shaderType)
+{
+    return *std::find_if(ShaderStages.begin(), ShaderStages.end(), [shaderType](const ShaderStage& stage)
+    {
+        return stage.ShaderType == shaderType;
+    });
+}
+
+template<typename T>
+static bool TryGetEnvironmentValue(const char* name, T& value)
+{
+    auto environmentValue = std::getenv(name);
+    if (environmentValue == nullptr)
+    {
+        return false;
+    }
+
+    std::string_view text = environmentValue;
+    auto [_, errorCode] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (errorCode != std::errc())
+    {
+        spdlog::warn("App: Ignoring {}={}, it is not a number", name, text);
+        return false;
+    }
+
+    return true;
+}
 
 class ApplicationAccess final
 {
@@ -29,7 +84,10 @@ public:
             application->framebufferWidth = framebufferWidth;
             application->framebufferHeight = framebufferHeight;
             application->OnFramebufferResized();
-            application->Render();
+            if (application->_isLoaded)
+            {
+                application->Render();
+            }
         }
     }
 
@@ -135,10 +193,23 @@ Application::~Application()
 
 }
 
-std::expected<std::string, std::string> Application::ReadTextFromFile(std::string_view filePath)
+std::expected<std::string, std::string> Application::ReadTextFromFile(std::string_view filePath) const
 {
-    std::ifstream file(filePath.data(), std::ios::ate);
-    if (file.bad())
+    if (auto packEntry = _assetPack.Find(filePath); packEntry != nullptr)
+    {
+        std::vector<std::byte> scratch;
+        auto packedContent = _assetPack.Read(*packEntry, scratch);
+        if (!packedContent.has_value())
+        {
+            return std::unexpected(packedContent.error());
+        }
+
+        return std::string(reinterpret_cast<const char*>(packedContent->data()), packedContent->size());
+    }
+
+    // bad() is not set when opening fails, only is_open() tells
+    std::ifstream file(std::string(filePath), std::ios::binary | std::ios::ate);
+    if (!file.is_open())
     {
         return std::unexpected(std::format("Io: Unable to read from file {}", filePath));
     }
@@ -154,42 +225,545 @@ std::expected<std::string, std::string> Application::ReadTextFromFile(std::strin
     return result;
 }
 
+std::expected<uint32_t, std::string> Application::CreateShaderProgram(
+    std::string_view label,
+    uint32_t shaderType,
+    std::string_view shaderSource)
+{
+    ZoneScopedN("CreateShaderProgram");
+    return _programCache.CreateShaderProgram(label, shaderType, shaderSource);
+}
+
+std::expected<Program, std::string> Application::CreateProgram(
+    std::string_view label,
+    const std::string& vertexShaderFilePath,
+    const std::string& fragmentShaderFilePath)
+{
+    auto programDescription = ProgramDescription
+    {
+        .Label = std::string(label),
+        .VertexShaderFilePath = vertexShaderFilePath,
+        .FragmentShaderFilePath = fragmentShaderFilePath,
+        .ComputeShaderFilePath = "",
+        .Defines = {}
+    };
+
+    return CreatePrograms(std::span(&programDescription, 1)).front();
+}
+
+std::expected<Program, std::string> Application::CreateComputeProgram(
+    std::string_view label,
+    const std::string& computeShaderFilePath)
+{
+    auto programDescription = ProgramDescription
+    {
+        .Label = std::string(label),
+        .VertexShaderFilePath = "",
+        .FragmentShaderFilePath = "",
+        .ComputeShaderFilePath = computeShaderFilePath,
+        .Defines = {}
+    };
+
+    return CreatePrograms(std::span(&programDescription, 1)).front();
+}
+
+std::vector<std::expected<Program, std::string>> Application::CreatePrograms(std::span<const ProgramDescription> programDescriptions)
+{
+    ZoneScopedN("CreatePrograms");
+
+    auto startTime = FrameClock::now();
+    struct PendingProgram
+    {
+        std::string Error;
+        std::vector<std::string> Files;
+        std::array<std::optional<PendingShaderProgram>, ShaderStages.size()> Stages;
+    };
+
+    auto endStages = [this](const ProgramDescription& programDescription, PendingProgram& pendingProgram, Program& program)
+    {
+        std::string error;
+        for (size_t stageIndex = 0; stageIndex < ShaderStages.size(); stageIndex++)
+        {
+            if (!pendingProgram.Stages[stageIndex].has_value())
+            {
+                continue;
+            }
+
+            auto& pendingStage = pendingProgram.Stages[stageIndex].value();
+            auto shaderProgram = _programCache.EndShaderProgram(pendingStage);
+            // a binary the driver would not specialize or link is no reason to fail, the GLSL it was built from still is there
+            if (!shaderProgram.has_value() && pendingStage.IsSpirv && pendingProgram.Error.empty())
+            {
+                spdlog::warn("App: SPIR-V of {} failed, compiling it from GLSL: {}", pendingStage.Label, shaderProgram.error());
+                auto shaderSource = _shaderPreprocessor.Preprocess(programDescription.*ShaderStages[stageIndex].FilePath, programDescription.Defines);
+                shaderProgram = shaderSource.has_value()
+                    ? _programCache.CreateShaderProgram(pendingStage.Label, ShaderStages[stageIndex].ShaderType, shaderSource->Source)
+                    : std::unexpected(shaderSource.error());
+                pendingStage.IsSpirv = false;
+            }
+
+            if (shaderProgram.has_value())
+            {
+                program.*ShaderStages[stageIndex].ShaderProgram = shaderProgram.value();
+            }
+            else if (error.empty())
+            {
+                error = shaderProgram.error();
+            }
+        }
+
+        return error;
+    };
+
+    auto deleteStages = [](const Program& program)
+    {
+        for (auto& stage : ShaderStages)
+        {
+            if (program.*stage.ShaderProgram != 0)
+            {
+                glDeleteProgram(program.*stage.ShaderProgram);
+            }
+        }
+    };
+
+    // kick off every stage first, the driver compiles them while we go on submitting
+    std::vector<PendingProgram> pendingPrograms(programDescriptions.size());
+    for (size_t programIndex = 0; programIndex < programDescriptions.size(); programIndex++)
+    {
+        auto& programDescription = programDescriptions[programIndex];
+        auto& pendingProgram = pendingPrograms[programIndex];
+
+        auto isGraphicsProgram = !programDescription.VertexShaderFilePath.empty() && !programDescription.FragmentShaderFilePath.empty();
+        auto isComputeProgram = !programDescription.ComputeShaderFilePath.empty();
+        if (isGraphicsProgram == isComputeProgram)
+        {
+            pendingProgram.Error = std::format("App: Program {} needs either a vertex and a fragment shader or a compute shader", programDescription.Label);
+            continue;
+        }
+
+        for (size_t stageIndex = 0; stageIndex < ShaderStages.size(); stageIndex++)
+        {
+            auto& stage = ShaderStages[stageIndex];
+            if ((programDescription.*stage.FilePath).empty())
+            {
+                continue;
+            }
+
+            auto pendingStage = BeginShaderStage(programDescription, stage.ShaderType, pendingProgram.Files);
+            if (!pendingStage.has_value())
+            {
+                pendingProgram.Error = pendingStage.error();
+                break;
+            }
+
+            pendingProgram.Stages[stageIndex] = pendingStage.value();
+        }
+
+        if (!pendingProgram.Error.empty())
+        {
+            Program startedProgram = {};
+            endStages(programDescription, pendingProgram, startedProgram);
+            deleteStages(startedProgram);
+            pendingProgram.Stages = {};
+        }
+    }
+
+    if (_programCache.IsParallelCompileSupported())
+    {
+        ZoneScopedN("WaitForCompilation");
+
+        auto isComplete = false;
+        while (!isComplete)
+        {
+            isComplete = true;
+            for (auto& pendingProgram : pendingPrograms)
+            {
+                for (auto& pendingStage : pendingProgram.Stages)
+                {
+                    isComplete = isComplete && (!pendingStage.has_value() || _programCache.IsShaderProgramComplete(pendingStage.value()));
+                }
+            }
+
+            if (!isComplete)
+            {
+                // keep the window responsive while the compiler threads are busy
+                glfwWaitEventsTimeout(0.001);
+            }
+        }
+    }
+
+    std::vector<std::expected<Program, std::string>> programs;
+    programs.reserve(programDescriptions.size());
+    for (size_t programIndex = 0; programIndex < pendingPrograms.size(); programIndex++)
+    {
+        auto& pendingProgram = pendingPrograms[programIndex];
+        if (!pendingProgram.Error.empty())
+        {
+            programs.push_back(std::unexpected(pendingProgram.Error));
+            continue;
+        }
+
+        Program program = {};
+        auto error = endStages(programDescriptions[programIndex], pendingProgram, program);
+        if (!error.empty())
+        {
+            deleteStages(program);
+            programs.push_back(std::unexpected(error));
+            continue;
+        }
+
+        glCreateProgramPipelines(1, &program.Id);
+        for (auto& stage : ShaderStages)
+        {
+            if (program.*stage.ShaderProgram != 0)
+            {
+                glUseProgramStages(program.Id, stage.StageBit, program.*stage.ShaderProgram);
+            }
+        }
+
+        programs.push_back(program);
+
+        if (settings.IsShaderHotReloadEnabled)
+        {
+            _trackedPrograms.push_back(
+            {
+                .Description = programDescriptions[programIndex],
+                .Current = program
+            });
+            // the Data/ copies next to the binary only change on the next build, edits happen in the source tree
+            for (auto& file : pendingProgram.Files)
+            {
+                auto sourceFilePath = _shaderPreprocessor.GetSourceFilePath(file);
+                _watchedShaderFiles[sourceFilePath] = FileWatcher::GetKey(file);
+                _fileWatcher.Watch(sourceFilePath);
+            }
+        }
+    }
+
+    size_t stageCount = 0;
+    size_t spirvStageCount = 0;
+    for (auto& pendingProgram : pendingPrograms)
+    {
+        for (auto& pendingStage : pendingProgram.Stages)
+        {
+            stageCount += pendingStage.has_value() ? 1 : 0;
+            spirvStageCount += pendingStage.has_value() && pendingStage->IsSpirv ? 1 : 0;
+        }
+    }
+
+    spdlog::info(
+        "App: Created {} programs in {:.1f}ms, {} of {} stages from SPIR-V",
+        programs.size(),
+        MillisecondsBetween(startTime, FrameClock::now()),
+        spirvStageCount,
+        stageCount);
+
+    return programs;
+}
+
+std::expected<PendingShaderProgram, std::string> Application::BeginShaderStage(
+    const ProgramDescription& programDescription,
+    uint32_t shaderType,
+    std::vector<std::string>& files)
+{
+    auto& stage = GetShaderStage(shaderType);
+    auto& filePath = programDescription.*stage.FilePath;
+    auto label = std::format("{}_{}", stage.LabelPrefix, programDescription.Label);
+    // preprocessed even when SPIR-V gets loaded, hot reload needs to know the included files
+    auto shaderSource = _shaderPreprocessor.Preprocess(filePath, programDescription.Defines);
+    if (!shaderSource.has_value())
+    {
+        return std::unexpected(shaderSource.error());
+    }
+
+    files.insert(files.end(), shaderSource->Files.begin(), shaderSource->Files.end());
+
+    if (settings.IsSpirvEnabled && _programCache.IsSpirvSupported() && programDescription.Defines.empty())
+    {
+        // SPIR-V is compiled at build time, once one of the GLSL files changed after that it is out of date
+        auto isChanged = std::any_of(shaderSource->Files.begin(), shaderSource->Files.end(), [&](const std::string& file)
+        {
+            return _shaderPreprocessor.IsChanged(file);
+        });
+        auto isSourceNewerThan = [&](const std::filesystem::path& spirvFilePath)
+        {
+            std::error_code errorCode;
+            auto spirvWriteTime = std::filesystem::last_write_time(spirvFilePath, errorCode);
+            return !errorCode && std::any_of(shaderSource->Files.begin(), shaderSource->Files.end(), [&](const std::string& file)
+            {
+                auto writeTime = std::filesystem::last_write_time(_shaderPreprocessor.GetSourceFilePath(file), errorCode);
+                return !errorCode && writeTime > spirvWriteTime;
+            });
+        };
+
+        auto spirvFilePath = filePath + ".spv";
+        if (auto packEntry = isChanged ? nullptr : _assetPack.Find(spirvFilePath); packEntry != nullptr)
+        {
+            std::vector<std::byte> scratch;
+            auto spirv = _assetPack.Read(*packEntry, scratch);
+            if (spirv.has_value())
+            {
+                return _programCache.BeginShaderProgram(label, shaderType, std::span(reinterpret_cast<const char*>(spirv->data()), spirv->size()));
+            }
+        }
+
+        std::ifstream spirvFile(spirvFilePath, std::ios::binary);
+        if (spirvFile.is_open() && !isChanged && !isSourceNewerThan(spirvFilePath))
+        {
+            std::vector<char> spirv((std::istreambuf_iterator<char>(spirvFile)), std::istreambuf_iterator<char>());
+            return _programCache.BeginShaderProgram(label, shaderType, std::span<const char>(spirv));
+        }
+    }
+
+    return _programCache.BeginShaderProgram(label, shaderType, std::string_view(shaderSource->Source));
+}
+
+void Application::DeleteProgram(const Program& program)
+{
+    auto trackedProgram = std::find_if(_trackedPrograms.begin(), _trackedPrograms.end(), [&](const TrackedProgram& tracked)
+    {
+        return tracked.Current.Id == program.Id;
+    });
+
+    auto& currentProgram = trackedProgram != _trackedPrograms.end()
+        ? trackedProgram->Current
+        : program;
+    for (auto& stage : ShaderStages)
+    {
+        if (currentProgram.*stage.ShaderProgram != 0)
+        {
+            glDeleteProgram(currentProgram.*stage.ShaderProgram);
+        }
+    }
+
+    if (trackedProgram != _trackedPrograms.end())
+    {
+        _trackedPrograms.erase(trackedProgram);
+    }
+
+    glDeleteProgramPipelines(1, &program.Id);
+}
+
+InputLayout Application::CreateInputLayout(
+    std::string_view label,
+    std::span<const InputLayoutElement> elements)
+{
+    return _inputLayoutCache.GetOrCreate(label, elements);
+}
+
 void Application::Run()
 {
-    if (!Initialize())
+    ReadSettingsFromEnvironment();
+
+    // started from the main thread, so it becomes thread 0 and helps out while waiting
+    _jobSystem.Initialize(settings.WorkerThreadCount);
+
+    if (!settings.AssetPackFilePath.empty())
     {
-        return;
+        auto openResult = _assetPack.Open(settings.AssetPackFilePath);
+        if (openResult.has_value())
+        {
+            spdlog::info("App: Opened asset pack {} with {} files", settings.AssetPackFilePath, _assetPack.GetEntries().size());
+        }
+        else
+        {
+            spdlog::info("App: Reading assets from disk. {}", openResult.error());
+        }
+    }
+
+    _shaderPreprocessor.SetAssetPack(&_assetPack);
+#if defined(OGS_SOURCE_DIRECTORY) && defined(OGS_BINARY_DIRECTORY)
+    _shaderPreprocessor.SetSourceDirectory(OGS_BINARY_DIRECTORY, OGS_SOURCE_DIRECTORY);
+#endif
+
+    {
+        ZoneScopedN("Initialize");
+        if (!Initialize())
+        {
+            return;
+        }
     }
 
     spdlog::info("App: Initialized");
 
-    if (!Load())
     {
-        return;
+        ZoneScopedN("Load");
+        if (!Load())
+        {
+            return;
+        }
     }
 
+    _isLoaded = true;
     spdlog::info("App: Loaded");
 
+    _gpuFrameTimer.Initialize();
+    _frameLimiter.SetTargetFrameRate(settings.FrameRateLimit);
+
+    auto fixedDeltaTime = 1.0 / settings.FixedUpdateRate;
+    auto maxAccumulatedTime = fixedDeltaTime * settings.MaxUpdatesPerFrame;
+    auto accumulatedTime = 0.0;
+    auto droppedSimulationTime = 0.0;
+
+    uint64_t frameIndex = 0;
+    auto startTime = FrameClock::now();
+    auto previousFrameStartTime = startTime;
+
     while (!glfwWindowShouldClose(_windowHandle))
     {
-        glfwPollEvents();
+        auto frameStartTime = FrameClock::now();
 
-        Update();
+        {
+            ZoneScopedN("Poll");
+            glfwPollEvents();
+            ReloadChangedShaders();
+        }
 
-        Render();
+        if (!settings.IsHeadless && glfwGetWindowAttrib(_windowHandle, GLFW_ICONIFIED) == GLFW_TRUE)
+        {
+            // nothing gets presented while minimized, sleep until something happens and keep the simulation paused
+            glfwWaitEventsTimeout(0.1);
+            previousFrameStartTime = FrameClock::now();
+            continue;
+        }
 
-        glfwSwapBuffers(_windowHandle);
+        auto pollEndTime = FrameClock::now();
+
+        accumulatedTime += std::chrono::duration<double>(frameStartTime - previousFrameStartTime).count();
+        previousFrameStartTime = frameStartTime;
+        if (accumulatedTime > maxAccumulatedTime)
+        {
+            // rather slow the simulation down than spiral into ever longer frames
+            droppedSimulationTime += accumulatedTime - maxAccumulatedTime;
+            accumulatedTime = maxAccumulatedTime;
+        }
+
+        _gpuFrameTimer.BeginFrame();
+
+        if (_offscreenFramebuffer != 0)
+        {
+            stateCache.BindFramebuffer(GL_FRAMEBUFFER, _offscreenFramebuffer);
+        }
+
+        {
+            ZoneScopedN("Update");
+            while (accumulatedTime >= fixedDeltaTime)
+            {
+                Update(static_cast<float>(fixedDeltaTime));
+                accumulatedTime -= fixedDeltaTime;
+            }
+        }
+
+        _interpolationAlpha = static_cast<float>(accumulatedTime / fixedDeltaTime);
+
+        _uploadContext.Update();
+        renderCounters.UploadedBytes += _assetLoader.Update();
+
+        auto updateEndTime = FrameClock::now();
+
+        {
+            ZoneScopedN("Render");
+            Render();
+        }
+
+        auto renderEndTime = FrameClock::now();
+
+        _gpuFrameTimer.EndFrame(_frameStatistics);
+
+        frameIndex++;
+        auto elapsedSeconds = std::chrono::duration<double>(renderEndTime - startTime).count();
+        auto isLastFrame =
+            (settings.FrameCount > 0 && frameIndex >= settings.FrameCount) ||
+            (settings.DurationInSeconds > 0.0 && elapsedSeconds >= settings.DurationInSeconds);
+        if (isLastFrame)
+        {
+            if (!settings.CaptureFilePath.empty())
+            {
+                CaptureFramebuffer(settings.CaptureFilePath);
+            }
+
+            Close();
+        }
+
+        {
+            ZoneScopedN("Swap");
+            glfwSwapBuffers(_windowHandle);
+        }
+
+        FrameMark;
+        TracyGpuCollect;
+        TracyPlot("DrawCalls", static_cast<int64_t>(renderCounters.DrawCalls));
+        TracyPlot("UploadedBytes", static_cast<int64_t>(renderCounters.UploadedBytes));
+        TracyPlot("StateChangesIssued", static_cast<int64_t>(stateCache.GetFrameCounters().IssuedCalls));
+        TracyPlot("StateChangesElided", static_cast<int64_t>(stateCache.GetFrameCounters().ElidedCalls));
+        renderCounters = {};
+        stateCache.ResetFrameCounters();
+
+        auto swapEndTime = FrameClock::now();
+
+        {
+            ZoneScopedN("Wait");
+            _frameLimiter.WaitForNextFrame();
+        }
+
+        auto frameEndTime = FrameClock::now();
+
+        _frameStatistics.Record(FrameTimingStage::Poll, MillisecondsBetween(frameStartTime, pollEndTime));
+        _frameStatistics.Record(FrameTimingStage::Update, MillisecondsBetween(pollEndTime, updateEndTime));
+        _frameStatistics.Record(FrameTimingStage::Render, MillisecondsBetween(updateEndTime, renderEndTime));
+        _frameStatistics.Record(FrameTimingStage::Swap, MillisecondsBetween(renderEndTime, swapEndTime));
+        _frameStatistics.Record(FrameTimingStage::Wait, MillisecondsBetween(swapEndTime, frameEndTime));
+        _frameStatistics.Record(FrameTimingStage::Frame, MillisecondsBetween(frameStartTime, frameEndTime));
     }
 
+    auto runSeconds = std::chrono::duration<double>(FrameClock::now() - startTime).count();
+    spdlog::info("App: Rendered {} frames in {:.3f}s", frameIndex, runSeconds);
+
+    _frameStatistics.LogSummary();
+
+    const auto& stateCounters = stateCache.GetTotalCounters();
+    spdlog::info(
+        "App: Issued {} state changes, elided {} redundant ones",
+        stateCounters.IssuedCalls,
+        stateCounters.ElidedCalls);
+
+    if (droppedSimulationTime > 0.0)
+    {
+        spdlog::warn("App: Dropped {:.3f}s of simulation time, updates could not keep up", droppedSimulationTime);
+    }
+
+    if (!settings.StatisticsFilePath.empty())
+    {
+        _frameStatistics.WriteToFile(settings.StatisticsFilePath);
+    }
+
+    if (_gpuFrameTimer.GetDroppedFrameCount() > 0)
+    {
+        spdlog::warn("App: Dropped {} gpu timings because their results were not ready in time", _gpuFrameTimer.GetDroppedFrameCount());
+    }
+
+    _gpuFrameTimer.Destroy();
+
     spdlog::info("App: Unloading");
 
-    Unload();
+    {
+        ZoneScopedN("Unload");
+        Unload();
+    }
+
+    _jobSystem.Destroy();
+    _assetPack.Close();
 
     spdlog::info("App: Unloaded");
 }
 
 bool Application::Initialize()
 {
+    if (settings.IsHeadless)
+    {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+
     if (glfwInit() == GLFW_FALSE)
     {
         spdlog::error("Glfw: Unable to initialize");
@@ -201,20 +775,46 @@ bool Application::Initialize()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
-    glfwWindowHint(GLFW_DECORATED, GLFW_TRUE);
-    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
+    if (settings.IsHeadless)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, settings.ContextApi == HeadlessContextApi::Egl
+            ? GLFW_EGL_CONTEXT_API
+            : GLFW_OSMESA_CONTEXT_API);
 
-    auto primaryMonitor = glfwGetPrimaryMonitor();
-    auto videoMode = glfwGetVideoMode(primaryMonitor);
+        _windowHandle = glfwCreateWindow(settings.HeadlessWidth, settings.HeadlessHeight, "OpenGL - Getting Started", nullptr, nullptr);
+        if (_windowHandle == nullptr)
+        {
+            // llvmpipe tops out at 4.5, which still has everything we need for DSA
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+            _windowHandle = glfwCreateWindow(settings.HeadlessWidth, settings.HeadlessHeight, "OpenGL - Getting Started", nullptr, nullptr);
+        }
+    }
+    else
+    {
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+        glfwWindowHint(GLFW_DECORATED, GLFW_TRUE);
+        glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
 
-    auto screenWidth = videoMode->width;
-    auto screenHeight = videoMode->height;
+        auto primaryMonitor = glfwGetPrimaryMonitor();
+        auto videoMode = glfwGetVideoMode(primaryMonitor);
+
+        auto screenWidth = videoMode->width;
+        auto screenHeight = videoMode->height;
 
-    auto windowWidth = static_cast<int32_t>(static_cast<float>(screenWidth) * 0.8f);
-    auto windowHeight = static_cast<int32_t>(static_cast<float>(screenHeight) * 0.8f);
+        auto windowWidth = static_cast<int32_t>(static_cast<float>(screenWidth) * 0.8f);
+        auto windowHeight = static_cast<int32_t>(static_cast<float>(screenHeight) * 0.8f);
+
+        _windowHandle = glfwCreateWindow(windowWidth, windowHeight, "OpenGL - Getting Started", nullptr, nullptr);
+        if (_windowHandle != nullptr)
+        {
+            int32_t monitorLeft = 0;
+            int32_t monitorTop = 0;
+            glfwGetMonitorPos(primaryMonitor, &monitorLeft, &monitorTop);
+            glfwSetWindowPos(_windowHandle, screenWidth / 2 - windowWidth / 2 + monitorLeft, screenHeight / 2 - windowHeight / 2 + monitorTop);
+        }
+    }
 
-    _windowHandle = glfwCreateWindow(windowWidth, windowHeight, "OpenGL - Getting Started", nullptr, nullptr);
     if (_windowHandle == nullptr)
     {
         const char* errorDescription = nullptr;
@@ -226,12 +826,20 @@ bool Application::Initialize()
         return false;
     }
 
-    glfwSetWindowUserPointer(_windowHandle, this);
+    if (settings.IsUploadThreadEnabled)
+    {
+        // same hints as the main window, just hidden and sharing its objects
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        auto uploadWindowHandle = glfwCreateWindow(1, 1, "Upload", nullptr, _windowHandle);
+        if (uploadWindowHandle == nullptr)
+        {
+            spdlog::warn("App: Unable to create a shared context, uploading on the render thread");
+        }
 
-    int32_t monitorLeft = 0;
-    int32_t monitorTop = 0;
-    glfwGetMonitorPos(primaryMonitor, &monitorLeft, &monitorTop);
-    glfwSetWindowPos(_windowHandle, screenWidth / 2 - windowWidth / 2 + monitorLeft, screenHeight / 2 - windowHeight / 2 + monitorTop);
+        _uploadContext.Initialize(uploadWindowHandle);
+    }
+
+    glfwSetWindowUserPointer(_windowHandle, this);
 
     glfwSetFramebufferSizeCallback(_windowHandle, ApplicationAccess::FramebufferResizeCallback);
     glfwSetKeyCallback(_windowHandle, ApplicationAccess::KeyCallback);
@@ -239,17 +847,45 @@ bool Application::Initialize()
     glfwMakeContextCurrent(_windowHandle);
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 
+    TracyGpuContext;
+
+    if (settings.IsHeadless)
+    {
+        glfwSwapInterval(0);
+
+        framebufferWidth = settings.HeadlessWidth;
+        framebufferHeight = settings.HeadlessHeight;
+        if (!CreateOffscreenFramebuffer())
+        {
+            return false;
+        }
+    }
+    else
+    {
+        glfwGetFramebufferSize(_windowHandle, &framebufferWidth, &framebufferHeight);
+    }
+
+    stateCache.Invalidate();
+    stateCache.SetViewport(0, 0, framebufferWidth, framebufferHeight);
+
     glDebugMessageCallback(ApplicationAccess::DebugMessageCallback, _windowHandle);
     glEnable(GL_DEBUG_OUTPUT);
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 
-    glEnable(GL_FRAMEBUFFER_SRGB);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
+    stateCache.SetEnabled(GL_FRAMEBUFFER_SRGB, true);
+    stateCache.SetEnabled(GL_CULL_FACE, true);
+    stateCache.SetCullFace(GL_BACK);
+    stateCache.SetFrontFace(GL_CCW);
+
+    stateCache.SetClearColor(0.35f, 0.76f, 0.16f, 1.0f);
+    stateCache.SetClearDepth(1.0f);
 
-    glClearColor(0.35f, 0.76f, 0.16f, 1.0f);
-    glClearDepthf(1.0f);
+    _programCache.Initialize(settings.ProgramCacheDirectoryPath);
+    if (settings.IsShaderHotReloadEnabled)
+    {
+        _fileWatcher.Initialize();
+    }
+    _assetLoader.Initialize(_jobSystem, &_uploadContext, &_assetPack, settings.AssetLoading);
 
     return true;
 }
@@ -261,6 +897,38 @@ bool Application::Load()
 
 void Application::Unload()
 {
+    DestroyOffscreenFramebuffer();
+    _fileWatcher.Destroy();
+    _uploadContext.Destroy();
+    _assetLoader.Destroy();
+
+    const auto& inputLayoutStatistics = _inputLayoutCache.GetStatistics();
+    spdlog::info(
+        "App: Created {} input layouts, reused them {} times",
+        inputLayoutStatistics.CreatedCount,
+        inputLayoutStatistics.ReusedCount);
+    _inputLayoutCache.Destroy();
+
+    const auto& programCacheStatistics = _programCache.GetStatistics();
+    if (_programCache.IsEnabled())
+    {
+        spdlog::info(
+            "App: Program cache hits {}, misses {}, rejected {}, compiling took {:.1f}ms, loading saved {:.1f}ms",
+            programCacheStatistics.HitCount,
+            programCacheStatistics.MissCount,
+            programCacheStatistics.RejectedCount,
+            programCacheStatistics.CompileMilliseconds,
+            programCacheStatistics.SavedMilliseconds);
+    }
+
+    auto glslMissCount = programCacheStatistics.MissCount - programCacheStatistics.SpirvMissCount;
+    spdlog::info(
+        "App: Built {} stages from GLSL in {:.1f}ms, {} from SPIR-V in {:.1f}ms",
+        glslMissCount,
+        programCacheStatistics.CompileMilliseconds - programCacheStatistics.SpirvCompileMilliseconds,
+        programCacheStatistics.SpirvMissCount,
+        programCacheStatistics.SpirvCompileMilliseconds);
+
     if (_windowHandle != nullptr)
     {
         glfwDestroyWindow(_windowHandle);
@@ -269,7 +937,7 @@ void Application::Unload()
     glfwTerminate();
 }
 
-void Application::Update()
+void Application::Update([[maybe_unused]] float deltaTime)
 {
 }
 
@@ -282,7 +950,7 @@ void Application::OnFramebufferResized()
 {
     spdlog::info("Framebuffer resized to {}_{}", framebufferWidth, framebufferHeight);
 
-    glViewport(0, 0, framebufferWidth, framebufferHeight);
+    stateCache.SetViewport(0, 0, framebufferWidth, framebufferHeight);
 }
 
 void Application::OnKeyDown(
@@ -292,7 +960,7 @@ void Application::OnKeyDown(
 {
     if (key == GLFW_KEY_ESCAPE)
     {
-        glfwSetWindowShouldClose(_windowHandle, GLFW_TRUE);
+        Close();
     }
 
     if (key == GLFW_KEY_F11)
@@ -317,6 +985,266 @@ void Application::OnOpenGLDebugMessage(uint32_t messageType, std::string_view de
     }
 }
 
+void Application::OnProgramReloaded([[maybe_unused]] const Program& program)
+{
+}
+
+void Application::Close()
+{
+    glfwSetWindowShouldClose(_windowHandle, GLFW_TRUE);
+}
+
+bool Application::IsHeadless() const
+{
+    return settings.IsHeadless;
+}
+
+const FrameStatistics& Application::GetFrameStatistics() const
+{
+    return _frameStatistics;
+}
+
+float Application::GetInterpolationAlpha() const
+{
+    return _interpolationAlpha;
+}
+
+JobSystem& Application::GetJobSystem()
+{
+    return _jobSystem;
+}
+
+AssetLoader& Application::GetAssetLoader()
+{
+    return _assetLoader;
+}
+
+const AssetPack& Application::GetAssetPack() const
+{
+    return _assetPack;
+}
+
+void Application::ReloadChangedShaders()
+{
+    if (_trackedPrograms.empty())
+    {
+        return;
+    }
+
+    auto changedFiles = _fileWatcher.Poll();
+    for (auto& changedFile : changedFiles)
+    {
+        auto startTime = FrameClock::now();
+        // a change to an include reloads every stage whose root file pulls it in
+        auto watchedFile = _watchedShaderFiles.find(FileWatcher::GetKey(changedFile));
+        auto affectedFiles = _shaderPreprocessor.Invalidate(watchedFile != _watchedShaderFiles.end() ? watchedFile->second : changedFile.string());
+        auto isAffected = [&](const std::string& filePath)
+        {
+            return std::find(affectedFiles.begin(), affectedFiles.end(), FileWatcher::GetKey(filePath)) != affectedFiles.end();
+        };
+
+        for (auto& trackedProgram : _trackedPrograms)
+        {
+            auto& description = trackedProgram.Description;
+            auto isReloaded = false;
+            for (auto& stage : ShaderStages)
+            {
+                auto& filePath = description.*stage.FilePath;
+                if (!filePath.empty() &&
+                    isAffected(filePath) &&
+                    ReloadShaderStage(trackedProgram, stage.ShaderType))
+                {
+                    spdlog::info("App: Reloaded {} of {} in {:.1f}ms", filePath, description.Label, MillisecondsBetween(startTime, FrameClock::now()));
+                    isReloaded = true;
+                }
+            }
+
+            if (isReloaded)
+            {
+                OnProgramReloaded(trackedProgram.Current);
+            }
+        }
+    }
+}
+
+bool Application::ReloadShaderStage(
+    TrackedProgram& trackedProgram,
+    uint32_t shaderType)
+{
+    ZoneScopedN("ReloadShaderStage");
+
+    auto& stage = GetShaderStage(shaderType);
+    auto& description = trackedProgram.Description;
+    auto& filePath = description.*stage.FilePath;
+
+    auto shaderSource = _shaderPreprocessor.Preprocess(filePath, description.Defines);
+    if (!shaderSource.has_value())
+    {
+        spdlog::error("App: Unable to reload {}. {}", filePath, shaderSource.error());
+        return false;
+    }
+
+    auto shaderProgram = _programCache.CreateShaderProgram(
+        std::format("{}_{}", stage.LabelPrefix, description.Label),
+        shaderType,
+        shaderSource->Source);
+    if (!shaderProgram.has_value())
+    {
+        // the old stage stays in the pipeline, fix the shader and save again
+        spdlog::error("App: Reloading {} failed, keeping the previous version. {}", filePath, shaderProgram.error());
+        return false;
+    }
+
+    auto& currentShaderProgram = trackedProgram.Current.*stage.ShaderProgram;
+    glUseProgramStages(trackedProgram.Current.Id, stage.StageBit, shaderProgram.value());
+    glDeleteProgram(currentShaderProgram);
+    currentShaderProgram = shaderProgram.value();
+    return true;
+}
+
+void Application::ReadSettingsFromEnvironment()
+{
+    if (auto headless = std::getenv("OGS_HEADLESS"); headless != nullptr)
+    {
+        std::string_view headlessValue = headless;
+        settings.IsHeadless = !headlessValue.empty() && headlessValue != "0";
+        if (headlessValue == "egl")
+        {
+            settings.ContextApi = HeadlessContextApi::Egl;
+        }
+        else if (headlessValue == "osmesa")
+        {
+            settings.ContextApi = HeadlessContextApi::OSMesa;
+        }
+    }
+
+    TryGetEnvironmentValue("OGS_WIDTH", settings.HeadlessWidth);
+    TryGetEnvironmentValue("OGS_HEIGHT", settings.HeadlessHeight);
+    TryGetEnvironmentValue("OGS_FRAME_COUNT", settings.FrameCount);
+    TryGetEnvironmentValue("OGS_DURATION", settings.DurationInSeconds);
+    TryGetEnvironmentValue("OGS_FRAME_RATE_LIMIT", settings.FrameRateLimit);
+    TryGetEnvironmentValue("OGS_UPDATE_RATE", settings.FixedUpdateRate);
+    TryGetEnvironmentValue("OGS_WORKER_THREADS", settings.WorkerThreadCount);
+
+    if (auto hotReload = std::getenv("OGS_HOT_RELOAD"); hotReload != nullptr)
+    {
+        settings.IsShaderHotReloadEnabled = std::string_view(hotReload) != "0";
+    }
+
+    if (auto spirv = std::getenv("OGS_SPIRV"); spirv != nullptr)
+    {
+        settings.IsSpirvEnabled = std::string_view(spirv) != "0";
+    }
+
+    if (auto uploadThread = std::getenv("OGS_UPLOAD_THREAD"); uploadThread != nullptr)
+    {
+        settings.IsUploadThreadEnabled = std::string_view(uploadThread) != "0";
+    }
+
+    if (auto captureFilePath = std::getenv("OGS_CAPTURE"); captureFilePath != nullptr)
+    {
+        settings.CaptureFilePath = captureFilePath;
+    }
+
+    if (auto statisticsFilePath = std::getenv("OGS_STATISTICS"); statisticsFilePath != nullptr)
+    {
+        settings.StatisticsFilePath = statisticsFilePath;
+    }
+
+    if (auto assetPackFilePath = std::getenv("OGS_ASSET_PACK"); assetPackFilePath != nullptr)
+    {
+        std::string_view assetPackFile = assetPackFilePath;
+        settings.AssetPackFilePath = assetPackFile == "0" ? std::string() : std::string(assetPackFile);
+    }
+
+    if (auto programCacheDirectoryPath = std::getenv("OGS_PROGRAM_CACHE"); programCacheDirectoryPath != nullptr)
+    {
+        // empty or 0 turns the cache off
+        std::string_view programCacheDirectory = programCacheDirectoryPath;
+        settings.ProgramCacheDirectoryPath = programCacheDirectory == "0" ? std::string() : std::string(programCacheDirectory);
+    }
+
+    if (settings.FixedUpdateRate <= 0.0)
+    {
+        spdlog::warn("App: Fixed update rate has to be positive, falling back to 60");
+        settings.FixedUpdateRate = 60.0;
+    }
+
+    if (settings.IsHeadless && settings.FrameCount == 0 && settings.DurationInSeconds <= 0.0)
+    {
+        spdlog::warn("App: Running headless without OGS_FRAME_COUNT or OGS_DURATION, this will not stop on its own");
+    }
+}
+
+bool Application::CreateOffscreenFramebuffer()
+{
+    glCreateRenderbuffers(1, &_offscreenColorAttachment);
+    glNamedRenderbufferStorage(_offscreenColorAttachment, GL_SRGB8_ALPHA8, framebufferWidth, framebufferHeight);
+    std::string_view label = "Renderbuffer_Offscreen_Color";
+    glObjectLabel(GL_RENDERBUFFER, _offscreenColorAttachment, label.size(), label.data());
+
+    glCreateRenderbuffers(1, &_offscreenDepthStencilAttachment);
+    glNamedRenderbufferStorage(_offscreenDepthStencilAttachment, GL_DEPTH24_STENCIL8, framebufferWidth, framebufferHeight);
+    label = "Renderbuffer_Offscreen_DepthStencil";
+    glObjectLabel(GL_RENDERBUFFER, _offscreenDepthStencilAttachment, label.size(), label.data());
+
+    glCreateFramebuffers(1, &_offscreenFramebuffer);
+    label = "Framebuffer_Offscreen";
+    glObjectLabel(GL_FRAMEBUFFER, _offscreenFramebuffer, label.size(), label.data());
+    glNamedFramebufferRenderbuffer(_offscreenFramebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _offscreenColorAttachment);
+    glNamedFramebufferRenderbuffer(_offscreenFramebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _offscreenDepthStencilAttachment);
+
+    auto framebufferStatus = glCheckNamedFramebufferStatus(_offscreenFramebuffer, GL_FRAMEBUFFER);
+    if (framebufferStatus != GL_FRAMEBUFFER_COMPLETE)
+    {
+        spdlog::error("App: Offscreen framebuffer is incomplete. Status {:#x}", framebufferStatus);
+        return false;
+    }
+
+    stateCache.BindFramebuffer(GL_FRAMEBUFFER, _offscreenFramebuffer);
+
+    spdlog::info("App: Rendering headless into a {}x{} offscreen framebuffer", framebufferWidth, framebufferHeight);
+
+    return true;
+}
+
+void Application::DestroyOffscreenFramebuffer()
+{
+    if (_offscreenFramebuffer == 0)
+    {
+        return;
+    }
+
+    stateCache.BindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &_offscreenFramebuffer);
+    glDeleteRenderbuffers(1, &_offscreenColorAttachment);
+    glDeleteRenderbuffers(1, &_offscreenDepthStencilAttachment);
+    _offscreenFramebuffer = 0;
+    _offscreenColorAttachment = 0;
+    _offscreenDepthStencilAttachment = 0;
+}
+
+bool Application::CaptureFramebuffer(std::string_view filePath)
+{
+    std::vector<uint8_t> pixels(static_cast<size_t>(framebufferWidth) * framebufferHeight * 4);
+
+    // _offscreenFramebuffer is 0 when windowed, which reads back the back buffer before it gets swapped
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, _offscreenFramebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, framebufferWidth, framebufferHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    stbi_flip_vertically_on_write(1);
+    std::string filePathString(filePath);
+    if (stbi_write_png(filePathString.c_str(), framebufferWidth, framebufferHeight, 4, pixels.data(), framebufferWidth * 4) == 0)
+    {
+        spdlog::error("App: Unable to write framebuffer capture to {}", filePath);
+        return false;
+    }
+
+    spdlog::info("App: Captured framebuffer to {}", filePath);
+    return true;
+}
+
 void Application::ToggleFullscreen()
 {
     _isFullscreen = !_isFullscreen;
@@ -1,11 +1,65 @@
 #pragma once
 
+#include "AssetLoader.hpp"
+#include "AssetPack.hpp"
+#include "FileWatcher.hpp"
+#include "FrameLimiter.hpp"
+#include "FrameStatistics.hpp"
+#include "GpuFrameTimer.hpp"
+#include "InputLayout.hpp"
+#include "InputLayoutCache.hpp"
+#include "JobSystem.hpp"
+#include "Program.hpp"
+#include "ProgramCache.hpp"
+#include "ShaderPreprocessor.hpp"
+#include "StateCache.hpp"
+#include "UploadContext.hpp"
+
 #include <cstdint>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include <expected>
+#include <span>
+#include <vector>
 
 struct GLFWwindow;
 
+enum class HeadlessContextApi
+{
+    OSMesa,
+    Egl
+};
+
+struct ApplicationSettings
+{
+    bool IsHeadless = false;
+    HeadlessContextApi ContextApi = HeadlessContextApi::OSMesa;
+    int32_t HeadlessWidth = 1280;
+    int32_t HeadlessHeight = 720;
+
+    uint64_t FrameCount = 0;
+    double DurationInSeconds = 0.0;
+    std::string CaptureFilePath;
+    std::string StatisticsFilePath;
+    std::string ProgramCacheDirectoryPath = "ProgramCache";
+    // built from Data/ by AssetPacker, files missing from it are read from disk
+    std::string AssetPackFilePath = "Data.pack";
+
+    double FixedUpdateRate = 60.0;
+    uint32_t MaxUpdatesPerFrame = 5;
+    double FrameRateLimit = 0.0;
+
+    // 0 starts one worker per core besides the main thread
+    uint32_t WorkerThreadCount = 0;
+
+    AssetLoaderSettings AssetLoading = {};
+    bool IsUploadThreadEnabled = false;
+    bool IsShaderHotReloadEnabled = true;
+    // stages load from the .spv glslang built next to their .glsl when the driver can, programs with defines and hot reloads use GLSL
+    bool IsSpirvEnabled = true;
+};
+
 class Application
 {
 public:
@@ -14,13 +68,34 @@ public:
     void Run();
 
 protected:
-    static std::expected<std::string, std::string> ReadTextFromFile(std::string_view filePath);
+    // looks in the asset pack first, then on disk
+    std::expected<std::string, std::string> ReadTextFromFile(std::string_view filePath) const;
+
+    std::expected<uint32_t, std::string> CreateShaderProgram(
+        std::string_view label,
+        uint32_t shaderType,
+        std::string_view shaderSource);
+    std::expected<Program, std::string> CreateProgram(
+        std::string_view label,
+        const std::string& vertexShaderFilePath,
+        const std::string& fragmentShaderFilePath);
+    // bind its pipeline and glDispatchCompute, nothing may be active through glUseProgram
+    std::expected<Program, std::string> CreateComputeProgram(
+        std::string_view label,
+        const std::string& computeShaderFilePath);
+    std::vector<std::expected<Program, std::string>> CreatePrograms(std::span<const ProgramDescription> programDescriptions);
+    // deletes the stages currently in the pipeline, which differ from program's after a hot reload
+    // unless the copy was replaced in OnProgramReloaded
+    void DeleteProgram(const Program& program);
+    InputLayout CreateInputLayout(
+        std::string_view label,
+        std::span<const InputLayoutElement> elements);
 
     virtual bool Initialize();
     virtual bool Load();
     virtual void Unload();
 
-    virtual void Update();
+    virtual void Update(float deltaTime);
     virtual void Render();
 
     virtual void OnFramebufferResized();
@@ -34,9 +109,26 @@ protected:
         int32_t scancode);
 
     virtual void OnOpenGLDebugMessage(uint32_t messageType, std::string_view debugMessage);
+    // a hot reload swapped new stages into program's pipeline and deleted the old ones, so the
+    // stage names in every earlier copy are gone and the new stages have default uniforms.
+    // Replace the copy with the one with the same Id and set its uniforms again.
+    virtual void OnProgramReloaded(const Program& program);
+
+    void Close();
+    bool IsHeadless() const;
+    const FrameStatistics& GetFrameStatistics() const;
+    float GetInterpolationAlpha() const;
+    JobSystem& GetJobSystem();
+    AssetLoader& GetAssetLoader();
+    const AssetPack& GetAssetPack() const;
 
     int32_t framebufferWidth = 0;
-    int32_t framebufferHeight = 0;    
+    int32_t framebufferHeight = 0;
+
+    RenderCounters renderCounters = {};
+    StateCache stateCache;
+
+    ApplicationSettings settings = {};
 
 private:
     friend class ApplicationAccess;
@@ -44,5 +136,46 @@ private:
     GLFWwindow* _windowHandle = nullptr;
     bool _isFullscreen = false;
 
+    FrameStatistics _frameStatistics;
+    GpuFrameTimer _gpuFrameTimer;
+    FrameLimiter _frameLimiter;
+    InputLayoutCache _inputLayoutCache;
+    ProgramCache _programCache;
+    ShaderPreprocessor _shaderPreprocessor;
+    JobSystem _jobSystem;
+    AssetPack _assetPack;
+    UploadContext _uploadContext;
+
+    struct TrackedProgram
+    {
+        ProgramDescription Description;
+        // the stages in the pipeline right now, Current.Id is the pipeline
+        Program Current;
+    };
+
+    FileWatcher _fileWatcher;
+    std::vector<TrackedProgram> _trackedPrograms;
+    // watched source tree file -> the file key programs were built from
+    std::unordered_map<std::string, std::string> _watchedShaderFiles;
+    AssetLoader _assetLoader;
+    float _interpolationAlpha = 0.0f;
+    bool _isLoaded = false;
+
+    uint32_t _offscreenFramebuffer = 0;
+    uint32_t _offscreenColorAttachment = 0;
+    uint32_t _offscreenDepthStencilAttachment = 0;
+
+    void ReadSettingsFromEnvironment();
+    std::expected<PendingShaderProgram, std::string> BeginShaderStage(
+        const ProgramDescription& programDescription,
+        uint32_t shaderType,
+        std::vector<std::string>& files);
+    void ReloadChangedShaders();
+    bool ReloadShaderStage(
+        TrackedProgram& trackedProgram,
+        uint32_t shaderType);
+    bool CreateOffscreenFramebuffer();
+    void DestroyOffscreenFramebuffer();
+    bool CaptureFramebuffer(std::string_view filePath);
     void ToggleFullscreen();
-};
\ No newline at end of file
+};
@@ -0,0 +1,444 @@
+#include "AssetLoader.hpp"
+#include "FrameStatistics.hpp"
+#include "Profiling.hpp"
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <format>
+#include <fstream>
+#include <memory>
+
+// packed files are viewed in place, everything else is read into storage
+static std::expected<std::span<const std::byte>, std::string> ReadBinaryFile(
+    const AssetPack* assetPack,
+    const std::string& filePath,
+    std::vector<std::byte>& storage)
+{
+    if (auto packEntry = assetPack != nullptr ? assetPack->Find(filePath) : nullptr; packEntry != nullptr)
+    {
+        return assetPack->Read(*packEntry, storage);
+    }
+
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        return std::unexpected(std::format("Io: Unable to read from file {}", filePath));
+    }
+
+    storage.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(storage.data()), static_cast<std::streamsize>(storage.size()));
+    if (!file)
+    {
+        return std::unexpected(std::format("Io: Unable to read from file {}", filePath));
+    }
+
+    return std::span<const std::byte>(storage);
+}
+
+static uint32_t CreateTexture(
+    std::string_view label,
+    bool isSrgb,
+    int32_t width,
+    int32_t height,
+    const void* pixels)
+{
+    uint32_t texture = 0;
+    auto mipCount = std::bit_width(static_cast<uint32_t>(std::max(width, height)));
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glObjectLabel(GL_TEXTURE, texture, static_cast<int32_t>(label.size()), label.data());
+    glTextureStorage2D(texture, mipCount, isSrgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, width, height);
+    glTextureSubImage2D(texture, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glGenerateTextureMipmap(texture);
+    return texture;
+}
+
+static uint32_t CreateBuffer(
+    std::string_view label,
+    std::span<const std::byte> data)
+{
+    uint32_t buffer = 0;
+    glCreateBuffers(1, &buffer);
+    glObjectLabel(GL_BUFFER, buffer, static_cast<int32_t>(label.size()), label.data());
+    glNamedBufferStorage(buffer, data.size(), data.data(), 0);
+    return buffer;
+}
+
+void AssetLoader::ImageDeleter::operator()(std::byte* pixels) const
+{
+    stbi_image_free(pixels);
+}
+
+size_t AssetLoader::LoadedAsset::GetSize() const
+{
+    return Pixels != nullptr
+        ? static_cast<size_t>(Width) * Height * 4
+        : Data.size();
+}
+
+void AssetLoader::Initialize(
+    JobSystem& jobSystem,
+    UploadContext* uploadContext,
+    const AssetPack* assetPack,
+    const AssetLoaderSettings& settings)
+{
+    _jobSystem = &jobSystem;
+    _uploadContext = uploadContext;
+    _assetPack = assetPack;
+    _settings = settings;
+
+    // magenta and black checker, easy to spot when something never finishes loading
+    auto placeholderPixels = std::to_array<uint32_t>({ 0xFFFF00FF, 0xFF000000, 0xFF000000, 0xFFFF00FF });
+    glCreateTextures(GL_TEXTURE_2D, 1, &_placeholderTexture);
+    glObjectLabel(GL_TEXTURE, _placeholderTexture, -1, "Texture_Placeholder");
+    glTextureStorage2D(_placeholderTexture, 1, GL_RGBA8, 2, 2);
+    glTextureSubImage2D(_placeholderTexture, 0, 0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixels.data());
+    glTextureParameteri(_placeholderTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(_placeholderTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+void AssetLoader::Destroy()
+{
+    if (_jobSystem == nullptr)
+    {
+        return;
+    }
+
+    // decoders write into our queue, let them finish before it goes away
+    _queuedRequests.clear();
+    _jobSystem->Wait(_inFlightJobs);
+    _loadedAssets.clear();
+    _inFlightCount = 0;
+
+    for (auto& texture : _textures)
+    {
+        if (texture.Id != 0)
+        {
+            glDeleteTextures(1, &texture.Id);
+        }
+    }
+
+    _textures.clear();
+
+    for (auto& buffer : _buffers)
+    {
+        if (buffer.Id != 0)
+        {
+            glDeleteBuffers(1, &buffer.Id);
+        }
+    }
+
+    _buffers.clear();
+    glDeleteTextures(1, &_placeholderTexture);
+    _placeholderTexture = 0;
+    _jobSystem = nullptr;
+}
+
+TextureHandle AssetLoader::LoadTexture(
+    std::string_view filePath,
+    bool isSrgb)
+{
+    TextureHandle handle = { .Index = static_cast<uint32_t>(_textures.size()) };
+    _textures.push_back({ .FilePath = std::string(filePath), .Id = 0, .IsSrgb = isSrgb, .State = AssetState::Queued });
+    _queuedRequests.push_back({ .FilePath = std::string(filePath), .Texture = handle, .Buffer = {}, .OnFileLoaded = nullptr });
+    return handle;
+}
+
+BufferHandle AssetLoader::LoadBuffer(std::string_view filePath)
+{
+    BufferHandle handle = { .Index = static_cast<uint32_t>(_buffers.size()) };
+    _buffers.push_back({ .FilePath = std::string(filePath), .Id = 0, .State = AssetState::Queued });
+    _queuedRequests.push_back({ .FilePath = std::string(filePath), .Texture = {}, .Buffer = handle, .OnFileLoaded = nullptr });
+    return handle;
+}
+
+void AssetLoader::ReadFileAsync(
+    std::string_view filePath,
+    FileLoadedCallback onLoaded)
+{
+    _queuedRequests.push_back({ .FilePath = std::string(filePath), .Texture = {}, .Buffer = {}, .OnFileLoaded = std::move(onLoaded) });
+}
+
+uint64_t AssetLoader::Update()
+{
+    ZoneScopedN("AssetLoader::Update");
+
+    while (!_queuedRequests.empty() && _inFlightCount < _settings.MaxQueuedAssetCount)
+    {
+        auto request = std::move(_queuedRequests.front());
+        _queuedRequests.pop_front();
+        if (request.Texture.Index != UINT32_MAX)
+        {
+            _textures[request.Texture.Index].State = AssetState::Loading;
+        }
+        else if (request.Buffer.Index != UINT32_MAX)
+        {
+            _buffers[request.Buffer.Index].State = AssetState::Loading;
+        }
+
+        // counts until uploaded, not until decoded, that is what bounds the decoded data in memory
+        _inFlightCount++;
+        _jobSystem->Run([this, request = std::move(request)]() mutable
+        {
+            Decode(std::move(request));
+        }, &_inFlightJobs);
+    }
+
+    auto startTime = FrameClock::now();
+    uint64_t uploadedBytes = 0;
+    uint64_t budgetedBytes = 0;
+    while (true)
+    {
+        LoadedAsset loadedAsset;
+        auto isOffloaded = false;
+        {
+            std::lock_guard lock(_loadedAssetMutex);
+            if (_loadedAssets.empty())
+            {
+                break;
+            }
+
+            // always upload at least one asset per frame, a single huge one must not starve
+            auto& nextAsset = _loadedAssets.front();
+            isOffloaded = IsOffloaded(nextAsset);
+            auto isOverBudget =
+                !isOffloaded &&
+                budgetedBytes > 0 &&
+                (budgetedBytes + nextAsset.GetSize() > _settings.UploadBudgetBytes ||
+                 MillisecondsBetween(startTime, FrameClock::now()) > _settings.UploadBudgetMilliseconds);
+            if (isOverBudget)
+            {
+                break;
+            }
+
+            loadedAsset = std::move(nextAsset);
+            _loadedAssets.pop_front();
+        }
+
+        uploadedBytes += loadedAsset.GetSize();
+        if (isOffloaded)
+        {
+            if (loadedAsset.Request.Texture.Index != UINT32_MAX)
+            {
+                SubmitTextureUpload(loadedAsset);
+            }
+            else
+            {
+                SubmitBufferUpload(loadedAsset);
+            }
+
+            continue;
+        }
+
+        budgetedBytes += loadedAsset.GetSize();
+        _inFlightCount--;
+        Upload(loadedAsset);
+    }
+
+    _statistics.UploadedBytes += uploadedBytes;
+    _statistics.PendingCount = static_cast<uint32_t>(_queuedRequests.size()) + _inFlightCount;
+    TracyPlot("PendingAssets", static_cast<int64_t>(_statistics.PendingCount));
+
+    return uploadedBytes;
+}
+
+uint32_t AssetLoader::GetTexture(TextureHandle handle) const
+{
+    if (handle.Index >= _textures.size() || _textures[handle.Index].State != AssetState::Ready)
+    {
+        return _placeholderTexture;
+    }
+
+    return _textures[handle.Index].Id;
+}
+
+AssetState AssetLoader::GetState(TextureHandle handle) const
+{
+    return handle.Index < _textures.size()
+        ? _textures[handle.Index].State
+        : AssetState::Failed;
+}
+
+uint32_t AssetLoader::GetBuffer(BufferHandle handle) const
+{
+    if (handle.Index >= _buffers.size() || _buffers[handle.Index].State != AssetState::Ready)
+    {
+        return 0;
+    }
+
+    return _buffers[handle.Index].Id;
+}
+
+AssetState AssetLoader::GetState(BufferHandle handle) const
+{
+    return handle.Index < _buffers.size()
+        ? _buffers[handle.Index].State
+        : AssetState::Failed;
+}
+
+bool AssetLoader::IsIdle() const
+{
+    return _queuedRequests.empty() && _inFlightCount == 0;
+}
+
+const AssetLoaderStatistics& AssetLoader::GetStatistics() const
+{
+    return _statistics;
+}
+
+void AssetLoader::Decode(AssetRequest request)
+{
+    ZoneScopedN("AssetLoader::Decode");
+
+    LoadedAsset loadedAsset = {};
+    std::vector<std::byte> fileStorage;
+    auto fileData = ReadBinaryFile(_assetPack, request.FilePath, fileStorage);
+    if (!fileData.has_value())
+    {
+        loadedAsset.Error = fileData.error();
+    }
+    else if (request.Texture.Index == UINT32_MAX)
+    {
+        // callers own what they get, only data viewed in the pack needs a copy
+        if (fileData->data() == fileStorage.data())
+        {
+            loadedAsset.Data = std::move(fileStorage);
+        }
+        else
+        {
+            loadedAsset.Data.assign(fileData->begin(), fileData->end());
+        }
+    }
+    else
+    {
+        auto width = 0;
+        auto height = 0;
+        auto componentCount = 0;
+        auto pixels = stbi_load_from_memory(
+            reinterpret_cast<const stbi_uc*>(fileData->data()),
+            static_cast<int32_t>(fileData->size()),
+            &width,
+            &height,
+            &componentCount,
+            STBI_rgb_alpha);
+        if (pixels == nullptr)
+        {
+            loadedAsset.Error = std::format("Io: Unable to decode image {}: {}", request.FilePath, stbi_failure_reason());
+        }
+        else
+        {
+            loadedAsset.Pixels.reset(reinterpret_cast<std::byte*>(pixels));
+            loadedAsset.Width = width;
+            loadedAsset.Height = height;
+        }
+    }
+
+    loadedAsset.Request = std::move(request);
+
+    std::lock_guard lock(_loadedAssetMutex);
+    _loadedAssets.push_back(std::move(loadedAsset));
+}
+
+void AssetLoader::Upload(LoadedAsset& loadedAsset)
+{
+    ZoneScopedN("AssetLoader::Upload");
+
+    auto& request = loadedAsset.Request;
+    if (request.OnFileLoaded)
+    {
+        if (loadedAsset.Error.empty())
+        {
+            request.OnFileLoaded(std::move(loadedAsset.Data));
+        }
+        else
+        {
+            _statistics.FailedCount++;
+            request.OnFileLoaded(std::unexpected(loadedAsset.Error));
+        }
+
+        return;
+    }
+
+    if (request.Buffer.Index != UINT32_MAX)
+    {
+        auto& buffer = _buffers[request.Buffer.Index];
+        if (!loadedAsset.Error.empty())
+        {
+            spdlog::error("App: {}", loadedAsset.Error);
+            buffer.State = AssetState::Failed;
+            _statistics.FailedCount++;
+            return;
+        }
+
+        buffer.Id = CreateBuffer(buffer.FilePath, loadedAsset.Data);
+        buffer.State = AssetState::Ready;
+        _statistics.LoadedBufferCount++;
+        return;
+    }
+
+    auto& texture = _textures[request.Texture.Index];
+    if (!loadedAsset.Error.empty())
+    {
+        spdlog::error("App: {}", loadedAsset.Error);
+        texture.State = AssetState::Failed;
+        _statistics.FailedCount++;
+        return;
+    }
+
+    texture.Id = CreateTexture(texture.FilePath, texture.IsSrgb, loadedAsset.Width, loadedAsset.Height, loadedAsset.Pixels.get());
+    texture.State = AssetState::Ready;
+    _statistics.LoadedTextureCount++;
+}
+
+bool AssetLoader::IsOffloaded(const LoadedAsset& loadedAsset) const
+{
+    return _uploadContext != nullptr &&
+        _uploadContext->IsEnabled() &&
+        loadedAsset.Error.empty() &&
+        (loadedAsset.Request.Texture.Index != UINT32_MAX || loadedAsset.Request.Buffer.Index != UINT32_MAX);
+}
+
+void AssetLoader::SubmitTextureUpload(LoadedAsset& loadedAsset)
+{
+    auto textureIndex = loadedAsset.Request.Texture.Index;
+    auto& texture = _textures[textureIndex];
+
+    // the upload thread only creates the texture, the handle flips to it on the render thread once fenced
+    auto textureUpload = std::make_shared<LoadedAsset>(std::move(loadedAsset));
+    auto uploadedTexture = std::make_shared<uint32_t>(0);
+    _uploadContext->Submit(
+        [textureUpload, uploadedTexture, label = texture.FilePath, isSrgb = texture.IsSrgb]()
+        {
+            *uploadedTexture = CreateTexture(label, isSrgb, textureUpload->Width, textureUpload->Height, textureUpload->Pixels.get());
+            textureUpload->Pixels.reset();
+        },
+        [this, uploadedTexture, textureIndex]()
+        {
+            auto& uploaded = _textures[textureIndex];
+            uploaded.Id = *uploadedTexture;
+            uploaded.State = AssetState::Ready;
+            _statistics.LoadedTextureCount++;
+            _inFlightCount--;
+        });
+}
+
+void AssetLoader::SubmitBufferUpload(LoadedAsset& loadedAsset)
+{
+    auto bufferIndex = loadedAsset.Request.Buffer.Index;
+    _uploadContext->SubmitBuffer(
+        _buffers[bufferIndex].FilePath,
+        std::move(loadedAsset.Data),
+        [this, bufferIndex](uint32_t uploadedBuffer)
+        {
+            auto& uploaded = _buffers[bufferIndex];
+            uploaded.Id = uploadedBuffer;
+            uploaded.State = AssetState::Ready;
+            _statistics.LoadedBufferCount++;
+            _inFlightCount--;
+        });
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "AssetPack.hpp"
+#include "JobSystem.hpp"
+#include "UploadContext.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct TextureHandle
+{
+    uint32_t Index = UINT32_MAX;
+};
+
+struct BufferHandle
+{
+    uint32_t Index = UINT32_MAX;
+};
+
+enum class AssetState
+{
+    Queued,
+    Loading,
+    Ready,
+    Failed
+};
+
+struct AssetLoaderSettings
+{
+    // upper bound of decoded data waiting for the GL thread, keeps memory in check while decoders outrun uploads
+    uint32_t MaxQueuedAssetCount = 16;
+    uint64_t UploadBudgetBytes = 16ull << 20;
+    double UploadBudgetMilliseconds = 2.0;
+};
+
+struct AssetLoaderStatistics
+{
+    uint64_t LoadedTextureCount = 0;
+    uint64_t LoadedBufferCount = 0;
+    uint64_t FailedCount = 0;
+    uint64_t UploadedBytes = 0;
+    uint32_t PendingCount = 0;
+};
+
+using FileLoadedCallback = std::function<void(std::expected<std::vector<std::byte>, std::string>)>;
+
+// Reads and decodes assets on the job system, the GL thread uploads them in Update within a
+// per frame budget. Texture handles resolve to a placeholder until their texture is uploaded,
+// buffer handles to 0 until their buffer is. With an enabled UploadContext textures and buffers
+// are created and filled on its thread instead, outside the budget.
+class AssetLoader
+{
+public:
+    void Initialize(
+        JobSystem& jobSystem,
+        UploadContext* uploadContext,
+        const AssetPack* assetPack,
+        const AssetLoaderSettings& settings = {});
+    void Destroy();
+
+    TextureHandle LoadTexture(
+        std::string_view filePath,
+        bool isSrgb = true);
+    // the whole file becomes an immutable buffer, for vertex, index or storage data
+    BufferHandle LoadBuffer(std::string_view filePath);
+    void ReadFileAsync(
+        std::string_view filePath,
+        FileLoadedCallback onLoaded);
+
+    // GL thread only, hands out work to the decoders and uploads finished assets, returns uploaded bytes
+    uint64_t Update();
+
+    uint32_t GetTexture(TextureHandle handle) const;
+    AssetState GetState(TextureHandle handle) const;
+    uint32_t GetBuffer(BufferHandle handle) const;
+    AssetState GetState(BufferHandle handle) const;
+    bool IsIdle() const;
+    const AssetLoaderStatistics& GetStatistics() const;
+
+private:
+    struct Texture
+    {
+        std::string FilePath;
+        uint32_t Id = 0;
+        bool IsSrgb = true;
+        AssetState State = AssetState::Queued;
+    };
+
+    struct Buffer
+    {
+        std::string FilePath;
+        uint32_t Id = 0;
+        AssetState State = AssetState::Queued;
+    };
+
+    struct AssetRequest
+    {
+        std::string FilePath;
+        TextureHandle Texture;
+        BufferHandle Buffer;
+        FileLoadedCallback OnFileLoaded;
+    };
+
+    // decoded pixels stay in stb_image's allocation until they are uploaded
+    struct ImageDeleter
+    {
+        void operator()(std::byte* pixels) const;
+    };
+
+    struct LoadedAsset
+    {
+        AssetRequest Request;
+        std::string Error;
+        std::vector<std::byte> Data;
+        std::unique_ptr<std::byte, ImageDeleter> Pixels;
+        int32_t Width = 0;
+        int32_t Height = 0;
+
+        size_t GetSize() const;
+    };
+
+    void Decode(AssetRequest request);
+    bool IsOffloaded(const LoadedAsset& loadedAsset) const;
+    void Upload(LoadedAsset& loadedAsset);
+    void SubmitTextureUpload(LoadedAsset& loadedAsset);
+    void SubmitBufferUpload(LoadedAsset& loadedAsset);
+
+    JobSystem* _jobSystem = nullptr;
+    UploadContext* _uploadContext = nullptr;
+    const AssetPack* _assetPack = nullptr;
+    AssetLoaderSettings _settings;
+    AssetLoaderStatistics _statistics;
+
+    uint32_t _placeholderTexture = 0;
+    std::vector<Texture> _textures;
+    std::vector<Buffer> _buffers;
+
+    std::deque<AssetRequest> _queuedRequests;
+    uint32_t _inFlightCount = 0;
+    JobCounter _inFlightJobs;
+
+    std::mutex _loadedAssetMutex;
+    std::deque<LoadedAsset> _loadedAssets;
+};
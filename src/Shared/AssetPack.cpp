@@ -0,0 +1,139 @@
+#include "AssetPack.hpp"
+#include "Hash.hpp"
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <format>
+
+std::expected<void, std::string> AssetPack::Open(const std::filesystem::path& filePath)
+{
+    Close();
+
+    auto openResult = _file.Open(filePath);
+    if (!openResult.has_value())
+    {
+        return openResult;
+    }
+
+    auto data = _file.GetData();
+
+    AssetPackHeader header = {};
+    if (data.size() >= sizeof(header))
+    {
+        std::copy_n(data.data(), sizeof(header), reinterpret_cast<std::byte*>(&header));
+    }
+
+    auto indexSize = static_cast<uint64_t>(header.EntryCount) * sizeof(AssetPackEntry);
+    auto isValid =
+        header.Magic == AssetPackMagic &&
+        header.Version == AssetPackVersion &&
+        header.IndexOffset % alignof(AssetPackEntry) == 0 &&
+        header.IndexOffset + indexSize <= data.size() &&
+        header.NamesOffset + header.NamesSize <= data.size();
+    if (!isValid)
+    {
+        Close();
+        return std::unexpected(std::format("Io: {} is not a version {} asset pack", filePath.string(), AssetPackVersion));
+    }
+
+    _entries = std::span(reinterpret_cast<const AssetPackEntry*>(data.data() + header.IndexOffset), header.EntryCount);
+    _names = std::string_view(reinterpret_cast<const char*>(data.data() + header.NamesOffset), header.NamesSize);
+
+    auto isEntryOutOfBounds = std::any_of(_entries.begin(), _entries.end(), [&](const AssetPackEntry& entry)
+    {
+        return entry.Offset + entry.StoredSize > data.size() ||
+            static_cast<uint64_t>(entry.NameOffset) + entry.NameSize > _names.size();
+    });
+    if (isEntryOutOfBounds)
+    {
+        Close();
+        return std::unexpected(std::format("Io: Asset pack {} is truncated", filePath.string()));
+    }
+
+    return {};
+}
+
+void AssetPack::Close()
+{
+    _file.Close();
+    _entries = {};
+    _names = {};
+}
+
+bool AssetPack::IsOpen() const
+{
+    return _file.IsOpen();
+}
+
+const AssetPackEntry* AssetPack::Find(const std::filesystem::path& filePath) const
+{
+    if (_entries.empty())
+    {
+        return nullptr;
+    }
+
+    auto key = GetKey(filePath);
+    auto pathHash = HashString(key);
+    auto entry = std::lower_bound(_entries.begin(), _entries.end(), pathHash, [](const AssetPackEntry& entry, uint64_t hash)
+    {
+        return entry.PathHash < hash;
+    });
+
+    for (; entry != _entries.end() && entry->PathHash == pathHash; ++entry)
+    {
+        if (GetName(*entry) == key)
+        {
+            return &*entry;
+        }
+    }
+
+    return nullptr;
+}
+
+std::expected<std::span<const std::byte>, std::string> AssetPack::Read(
+    const AssetPackEntry& entry,
+    std::vector<std::byte>& scratch) const
+{
+    auto storedData = _file.GetData().subspan(entry.Offset, entry.StoredSize);
+    if (entry.Compression == AssetPackCompression::None)
+    {
+        return storedData;
+    }
+
+    if (entry.Compression != AssetPackCompression::Lz4)
+    {
+        return std::unexpected(std::format("Io: {} uses an unknown compression", GetName(entry)));
+    }
+
+    scratch.resize(entry.Size);
+    auto decompressedSize = LZ4_decompress_safe(
+        reinterpret_cast<const char*>(storedData.data()),
+        reinterpret_cast<char*>(scratch.data()),
+        static_cast<int32_t>(storedData.size()),
+        static_cast<int32_t>(scratch.size()));
+    if (decompressedSize < 0 || static_cast<uint64_t>(decompressedSize) != entry.Size)
+    {
+        return std::unexpected(std::format("Io: Unable to decompress {}", GetName(entry)));
+    }
+
+    return std::span<const std::byte>(scratch);
+}
+
+std::string_view AssetPack::GetName(const AssetPackEntry& entry) const
+{
+    return _names.substr(entry.NameOffset, entry.NameSize);
+}
+
+std::span<const AssetPackEntry> AssetPack::GetEntries() const
+{
+    return _entries;
+}
+
+std::string AssetPack::GetKey(const std::filesystem::path& filePath)
+{
+    auto relativePath = filePath.is_absolute()
+        ? filePath.lexically_relative(std::filesystem::current_path())
+        : filePath;
+    return relativePath.lexically_normal().generic_string();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Data.pack layout: header, index sorted by path hash, path names, then every entry's data
+// starting on an AssetPackAlignment boundary. Written by tools/AssetPacker.
+constexpr uint32_t AssetPackMagic = 0x4B505341; // "ASPK"
+constexpr uint32_t AssetPackVersion = 1;
+constexpr uint64_t AssetPackAlignment = 64;
+
+enum class AssetPackCompression : uint32_t
+{
+    None,
+    Lz4
+};
+
+struct AssetPackHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t EntryCount;
+    uint32_t NamesSize;
+    uint64_t IndexOffset;
+    uint64_t NamesOffset;
+};
+
+struct AssetPackEntry
+{
+    uint64_t PathHash;
+    uint64_t Offset;
+    uint64_t StoredSize;
+    uint64_t Size;
+    uint32_t NameOffset;
+    uint32_t NameSize;
+    AssetPackCompression Compression;
+    uint32_t Reserved;
+};
+
+static_assert(sizeof(AssetPackHeader) == 32);
+static_assert(sizeof(AssetPackEntry) == 48);
+
+// Read only view of a memory mapped asset pack. Lookups are a binary search over the mapped
+// index and stored entries are handed out without copying, so it is safe to use from any thread.
+class AssetPack
+{
+public:
+    std::expected<void, std::string> Open(const std::filesystem::path& filePath);
+    void Close();
+    bool IsOpen() const;
+
+    const AssetPackEntry* Find(const std::filesystem::path& filePath) const;
+    // points into the mapping for stored entries, compressed ones get decompressed into scratch
+    std::expected<std::span<const std::byte>, std::string> Read(
+        const AssetPackEntry& entry,
+        std::vector<std::byte>& scratch) const;
+    std::string_view GetName(const AssetPackEntry& entry) const;
+    std::span<const AssetPackEntry> GetEntries() const;
+
+    // relative to the working directory with forward slashes, "Data/Shaders/Simple.vs.glsl"
+    static std::string GetKey(const std::filesystem::path& filePath);
+
+private:
+    MappedFile _file;
+    std::span<const AssetPackEntry> _entries;
+    std::string_view _names;
+};
@@ -0,0 +1,249 @@
+#include "BufferArena.hpp"
+#include "Profiling.hpp"
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <format>
+
+bool BufferArena::Initialize(
+    std::string_view label,
+    uint32_t vertexStride,
+    uint32_t vertexCapacity,
+    uint32_t indexCapacity)
+{
+    if (vertexStride == 0 || vertexCapacity == 0 || indexCapacity == 0)
+    {
+        spdlog::error("BufferArena: {} needs a vertex stride and capacities", label);
+        return false;
+    }
+
+    _label = label;
+    _vertexStride = vertexStride;
+
+    glCreateBuffers(1, &_vertexBuffer);
+    auto vertexBufferLabel = std::format("VertexBuffer_{}", label);
+    glObjectLabel(GL_BUFFER, _vertexBuffer, vertexBufferLabel.size(), vertexBufferLabel.data());
+    glNamedBufferStorage(_vertexBuffer, static_cast<size_t>(vertexCapacity) * vertexStride, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    glCreateBuffers(1, &_indexBuffer);
+    auto indexBufferLabel = std::format("IndexBuffer_{}", label);
+    glObjectLabel(GL_BUFFER, _indexBuffer, indexBufferLabel.size(), indexBufferLabel.data());
+    glNamedBufferStorage(_indexBuffer, static_cast<size_t>(indexCapacity) * sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    _vertexAllocator.Reset(vertexCapacity);
+    _indexAllocator.Reset(indexCapacity);
+    _meshSlots.clear();
+    _freeMeshSlots.clear();
+
+    return true;
+}
+
+void BufferArena::Destroy()
+{
+    if (_vertexBuffer != 0)
+    {
+        glDeleteBuffers(1, &_vertexBuffer);
+        _vertexBuffer = 0;
+    }
+
+    if (_indexBuffer != 0)
+    {
+        glDeleteBuffers(1, &_indexBuffer);
+        _indexBuffer = 0;
+    }
+
+    _meshSlots.clear();
+    _freeMeshSlots.clear();
+}
+
+std::optional<MeshHandle> BufferArena::Allocate(
+    std::span<const std::byte> vertices,
+    std::span<const uint32_t> indices)
+{
+    if (vertices.empty() || indices.empty())
+    {
+        spdlog::error("BufferArena: {} can't allocate a mesh without vertices or indices", _label);
+        return std::nullopt;
+    }
+
+    // a partial vertex would be uploaded past the end of the allocation into the next mesh
+    if (vertices.size() % _vertexStride != 0)
+    {
+        spdlog::error("BufferArena: {} got {} bytes of vertices, which is not a multiple of the {} byte stride", _label, vertices.size(), _vertexStride);
+        return std::nullopt;
+    }
+
+    auto vertexCount = static_cast<uint32_t>(vertices.size() / _vertexStride);
+    auto indexCount = static_cast<uint32_t>(indices.size());
+
+    auto hasEnoughFreeSpace =
+        _vertexAllocator.GetFreeSize() >= vertexCount &&
+        _indexAllocator.GetFreeSize() >= indexCount;
+    auto hasLargeEnoughBlocks =
+        _vertexAllocator.GetLargestFreeBlockSize() >= vertexCount &&
+        _indexAllocator.GetLargestFreeBlockSize() >= indexCount;
+    if (!hasEnoughFreeSpace)
+    {
+        spdlog::error("BufferArena: {} is out of space for {} vertices and {} indices", _label, vertexCount, indexCount);
+        return std::nullopt;
+    }
+
+    if (!hasLargeEnoughBlocks)
+    {
+        spdlog::info("BufferArena: {} is fragmented, defragmenting", _label);
+        Defragment();
+    }
+
+    auto vertexOffset = _vertexAllocator.Allocate(vertexCount);
+    auto indexOffset = _indexAllocator.Allocate(indexCount);
+    if (!vertexOffset.has_value() || !indexOffset.has_value())
+    {
+        if (vertexOffset.has_value())
+        {
+            _vertexAllocator.Free(vertexOffset.value(), vertexCount);
+        }
+
+        if (indexOffset.has_value())
+        {
+            _indexAllocator.Free(indexOffset.value(), indexCount);
+        }
+
+        spdlog::error("BufferArena: {} is out of space for {} vertices and {} indices", _label, vertexCount, indexCount);
+        return std::nullopt;
+    }
+
+    glNamedBufferSubData(_vertexBuffer, vertexOffset.value() * _vertexStride, vertices.size(), vertices.data());
+    glNamedBufferSubData(_indexBuffer, indexOffset.value() * sizeof(uint32_t), indices.size_bytes(), indices.data());
+
+    MeshHandle meshHandle = {};
+    if (_freeMeshSlots.empty())
+    {
+        meshHandle.Index = static_cast<uint32_t>(_meshSlots.size());
+        _meshSlots.emplace_back();
+    }
+    else
+    {
+        meshHandle.Index = _freeMeshSlots.back();
+        _freeMeshSlots.pop_back();
+    }
+
+    _meshSlots[meshHandle.Index] =
+    {
+        .Mesh =
+        {
+            .BaseVertex = static_cast<int32_t>(vertexOffset.value()),
+            .VertexCount = vertexCount,
+            .FirstIndex = static_cast<uint32_t>(indexOffset.value()),
+            .IndexCount = indexCount
+        },
+        .IsAlive = true
+    };
+
+    return meshHandle;
+}
+
+void BufferArena::Free(MeshHandle meshHandle)
+{
+    if (meshHandle.Index >= _meshSlots.size() || !_meshSlots[meshHandle.Index].IsAlive)
+    {
+        return;
+    }
+
+    auto& meshSlot = _meshSlots[meshHandle.Index];
+    _vertexAllocator.Free(static_cast<uint64_t>(meshSlot.Mesh.BaseVertex), meshSlot.Mesh.VertexCount);
+    _indexAllocator.Free(meshSlot.Mesh.FirstIndex, meshSlot.Mesh.IndexCount);
+    meshSlot.IsAlive = false;
+    _freeMeshSlots.push_back(meshHandle.Index);
+}
+
+const MeshAllocation& BufferArena::GetMesh(MeshHandle meshHandle) const
+{
+    return _meshSlots[meshHandle.Index].Mesh;
+}
+
+void BufferArena::Defragment()
+{
+    ZoneScopedN("BufferArena::Defragment");
+
+    std::vector<uint32_t> liveMeshes;
+    for (uint32_t meshIndex = 0; meshIndex < _meshSlots.size(); meshIndex++)
+    {
+        if (_meshSlots[meshIndex].IsAlive)
+        {
+            liveMeshes.push_back(meshIndex);
+        }
+    }
+
+    uint64_t liveVertexCount = 0;
+    uint64_t liveIndexCount = 0;
+    for (auto meshIndex : liveMeshes)
+    {
+        liveVertexCount += _meshSlots[meshIndex].Mesh.VertexCount;
+        liveIndexCount += _meshSlots[meshIndex].Mesh.IndexCount;
+    }
+
+    if (liveVertexCount > 0 || liveIndexCount > 0)
+    {
+        // compact into a scratch buffer first, moving ranges within one buffer could overlap
+        auto scratchVertexSize = liveVertexCount * _vertexStride;
+        auto scratchIndexSize = liveIndexCount * sizeof(uint32_t);
+        uint32_t scratchBuffer = 0;
+        glCreateBuffers(1, &scratchBuffer);
+        glNamedBufferStorage(scratchBuffer, scratchVertexSize + scratchIndexSize, nullptr, 0);
+
+        uint64_t nextVertex = 0;
+        uint64_t nextIndex = 0;
+        for (auto meshIndex : liveMeshes)
+        {
+            auto& mesh = _meshSlots[meshIndex].Mesh;
+            glCopyNamedBufferSubData(_vertexBuffer, scratchBuffer, static_cast<uint64_t>(mesh.BaseVertex) * _vertexStride, nextVertex * _vertexStride, static_cast<size_t>(mesh.VertexCount) * _vertexStride);
+            glCopyNamedBufferSubData(_indexBuffer, scratchBuffer, static_cast<uint64_t>(mesh.FirstIndex) * sizeof(uint32_t), scratchVertexSize + nextIndex * sizeof(uint32_t), mesh.IndexCount * sizeof(uint32_t));
+
+            mesh.BaseVertex = static_cast<int32_t>(nextVertex);
+            mesh.FirstIndex = static_cast<uint32_t>(nextIndex);
+            nextVertex += mesh.VertexCount;
+            nextIndex += mesh.IndexCount;
+        }
+
+        glCopyNamedBufferSubData(scratchBuffer, _vertexBuffer, 0, 0, scratchVertexSize);
+        glCopyNamedBufferSubData(scratchBuffer, _indexBuffer, scratchVertexSize, 0, scratchIndexSize);
+        glDeleteBuffers(1, &scratchBuffer);
+    }
+
+    _vertexAllocator.Reset(_vertexAllocator.GetCapacity(), liveVertexCount);
+    _indexAllocator.Reset(_indexAllocator.GetCapacity(), liveIndexCount);
+}
+
+float BufferArena::GetFragmentation() const
+{
+    auto freeVertexCount = _vertexAllocator.GetFreeSize();
+    if (freeVertexCount == 0)
+    {
+        return 0.0f;
+    }
+
+    return 1.0f - static_cast<float>(_vertexAllocator.GetLargestFreeBlockSize()) / static_cast<float>(freeVertexCount);
+}
+
+void BufferArena::Bind(InputLayout& inputLayout, uint32_t bindingIndex) const
+{
+    inputLayout.AddVertexBufferBinding(_vertexBuffer, bindingIndex, 0, _vertexStride);
+    inputLayout.AddIndexBufferBinding(_indexBuffer);
+}
+
+uint32_t BufferArena::GetVertexBuffer() const
+{
+    return _vertexBuffer;
+}
+
+uint32_t BufferArena::GetIndexBuffer() const
+{
+    return _indexBuffer;
+}
+
+uint32_t BufferArena::GetVertexStride() const
+{
+    return _vertexStride;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "FreeListAllocator.hpp"
+#include "InputLayout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct MeshAllocation
+{
+    int32_t BaseVertex = 0;
+    uint32_t VertexCount = 0;
+    uint32_t FirstIndex = 0;
+    uint32_t IndexCount = 0;
+};
+
+struct MeshHandle
+{
+    uint32_t Index = UINT32_MAX;
+};
+
+// Suballocates the vertices and indices of many meshes from one immutable vertex buffer and
+// one index buffer. Indices stay mesh local, meshes are drawn with their BaseVertex, so a
+// single InputLayout bound once can draw every mesh in the arena.
+class BufferArena
+{
+public:
+    bool Initialize(
+        std::string_view label,
+        uint32_t vertexStride,
+        uint32_t vertexCapacity,
+        uint32_t indexCapacity);
+    void Destroy();
+
+    std::optional<MeshHandle> Allocate(
+        std::span<const std::byte> vertices,
+        std::span<const uint32_t> indices);
+
+    template<typename TVertex>
+    std::optional<MeshHandle> Allocate(
+        std::span<const TVertex> vertices,
+        std::span<const uint32_t> indices)
+    {
+        return Allocate(std::as_bytes(vertices), indices);
+    }
+
+    void Free(MeshHandle meshHandle);
+    const MeshAllocation& GetMesh(MeshHandle meshHandle) const;
+
+    // moves every live mesh to the front of the buffers, buffer names stay the same
+    void Defragment();
+    float GetFragmentation() const;
+
+    void Bind(InputLayout& inputLayout, uint32_t bindingIndex = 0) const;
+
+    uint32_t GetVertexBuffer() const;
+    uint32_t GetIndexBuffer() const;
+    uint32_t GetVertexStride() const;
+
+private:
+    struct MeshSlot
+    {
+        MeshAllocation Mesh;
+        bool IsAlive = false;
+    };
+
+    std::string _label;
+    uint32_t _vertexBuffer = 0;
+    uint32_t _indexBuffer = 0;
+    uint32_t _vertexStride = 0;
+
+    FreeListAllocator _vertexAllocator;
+    FreeListAllocator _indexAllocator;
+
+    std::vector<MeshSlot> _meshSlots;
+    std::vector<uint32_t> _freeMeshSlots;
+};
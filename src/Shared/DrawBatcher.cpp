@@ -0,0 +1,144 @@
+#include "DrawBatcher.hpp"
+#include "Profiling.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <format>
+
+bool DrawBatcher::Initialize(
+    std::string_view label,
+    uint32_t maxDrawsPerFrame,
+    uint32_t framesInFlight)
+{
+    _drawRequests.reserve(maxDrawsPerFrame);
+    return _commandBuffer.Initialize(
+        std::format("DrawCommands_{}", label),
+        static_cast<size_t>(maxDrawsPerFrame) * sizeof(DrawElementsIndirectCommand),
+        framesInFlight);
+}
+
+void DrawBatcher::Destroy()
+{
+    _commandBuffer.Destroy();
+    _drawRequests.clear();
+}
+
+void DrawBatcher::BeginFrame()
+{
+    _commandBuffer.BeginFrame();
+    _drawRequests.clear();
+    _statistics = {};
+}
+
+void DrawBatcher::Add(
+    const InputLayout& inputLayout,
+    const Program& program,
+    const MeshAllocation& mesh,
+    uint32_t baseInstance,
+    uint32_t instanceCount)
+{
+    _drawRequests.push_back(
+    {
+        .InputLayoutId = inputLayout.Id,
+        .ProgramPipelineId = program.Id,
+        .Command =
+        {
+            .IndexCount = mesh.IndexCount,
+            .InstanceCount = instanceCount,
+            .FirstIndex = mesh.FirstIndex,
+            .BaseVertex = mesh.BaseVertex,
+            .BaseInstance = baseInstance
+        }
+    });
+}
+
+void DrawBatcher::Submit(
+    StateCache& stateCache,
+    uint32_t primitiveType)
+{
+    ZoneScopedN("DrawBatcher::Submit");
+
+    if (_drawRequests.empty())
+    {
+        return;
+    }
+
+    std::stable_sort(_drawRequests.begin(), _drawRequests.end(), [](const DrawRequest& left, const DrawRequest& right)
+    {
+        return left.InputLayoutId != right.InputLayoutId
+            ? left.InputLayoutId < right.InputLayoutId
+            : left.ProgramPipelineId < right.ProgramPipelineId;
+    });
+
+    stateCache.BindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer.GetBuffer());
+
+    size_t batchStart = 0;
+    while (batchStart < _drawRequests.size())
+    {
+        auto& firstRequest = _drawRequests[batchStart];
+        auto batchEnd = batchStart + 1;
+        while (batchEnd < _drawRequests.size() &&
+               _drawRequests[batchEnd].InputLayoutId == firstRequest.InputLayoutId &&
+               _drawRequests[batchEnd].ProgramPipelineId == firstRequest.ProgramPipelineId)
+        {
+            batchEnd++;
+        }
+
+        stateCache.BindVertexArray(firstRequest.InputLayoutId);
+        stateCache.BindProgramPipeline(firstRequest.ProgramPipelineId);
+
+        auto drawCount = batchEnd - batchStart;
+        auto commands = _commandBuffer.Allocate(drawCount * sizeof(DrawElementsIndirectCommand), alignof(DrawElementsIndirectCommand));
+        if (commands.has_value())
+        {
+            auto commandData = reinterpret_cast<DrawElementsIndirectCommand*>(commands->Data);
+            for (size_t drawIndex = 0; drawIndex < drawCount; drawIndex++)
+            {
+                commandData[drawIndex] = _drawRequests[batchStart + drawIndex].Command;
+            }
+
+            glMultiDrawElementsIndirect(
+                primitiveType,
+                GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(commands->Offset),
+                static_cast<int32_t>(drawCount),
+                0);
+            _statistics.BatchCount++;
+        }
+        else
+        {
+            // out of command space for this frame, still draw everything, just the slow way
+            for (size_t drawIndex = batchStart; drawIndex < batchEnd; drawIndex++)
+            {
+                auto& command = _drawRequests[drawIndex].Command;
+                glDrawElementsInstancedBaseVertexBaseInstance(
+                    primitiveType,
+                    static_cast<int32_t>(command.IndexCount),
+                    GL_UNSIGNED_INT,
+                    reinterpret_cast<const void*>(static_cast<size_t>(command.FirstIndex) * sizeof(uint32_t)),
+                    static_cast<int32_t>(command.InstanceCount),
+                    command.BaseVertex,
+                    command.BaseInstance);
+            }
+
+            _statistics.OverflowDrawCount += drawCount;
+            _statistics.BatchCount += drawCount;
+        }
+
+        _statistics.DrawCount += drawCount;
+        batchStart = batchEnd;
+    }
+
+    _drawRequests.clear();
+}
+
+void DrawBatcher::EndFrame()
+{
+    _commandBuffer.EndFrame();
+}
+
+const DrawBatcherStatistics& DrawBatcher::GetStatistics() const
+{
+    return _statistics;
+}
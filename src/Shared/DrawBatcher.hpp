@@ -0,0 +1,66 @@
+#pragma once
+
+#include "BufferArena.hpp"
+#include "InputLayout.hpp"
+#include "Program.hpp"
+#include "RingBuffer.hpp"
+#include "StateCache.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+struct DrawElementsIndirectCommand
+{
+    uint32_t IndexCount;
+    uint32_t InstanceCount;
+    uint32_t FirstIndex;
+    int32_t BaseVertex;
+    uint32_t BaseInstance;
+};
+
+struct DrawBatcherStatistics
+{
+    uint64_t DrawCount = 0;
+    uint64_t BatchCount = 0;
+    uint64_t OverflowDrawCount = 0;
+};
+
+// Collects indexed draws, sorts them by input layout and program pipeline and submits every
+// run sharing both with one glMultiDrawElementsIndirect. BaseInstance is passed through, so
+// shaders find their per-draw data with gl_BaseInstance/gl_DrawID, or through instanced attributes.
+class DrawBatcher
+{
+public:
+    bool Initialize(
+        std::string_view label,
+        uint32_t maxDrawsPerFrame,
+        uint32_t framesInFlight = 3);
+    void Destroy();
+
+    void BeginFrame();
+    void Add(
+        const InputLayout& inputLayout,
+        const Program& program,
+        const MeshAllocation& mesh,
+        uint32_t baseInstance,
+        uint32_t instanceCount = 1);
+    void Submit(
+        StateCache& stateCache,
+        uint32_t primitiveType);
+    void EndFrame();
+
+    const DrawBatcherStatistics& GetStatistics() const;
+
+private:
+    struct DrawRequest
+    {
+        uint32_t InputLayoutId;
+        uint32_t ProgramPipelineId;
+        DrawElementsIndirectCommand Command;
+    };
+
+    RingBuffer _commandBuffer;
+    std::vector<DrawRequest> _drawRequests;
+    DrawBatcherStatistics _statistics;
+};
@@ -0,0 +1,140 @@
+#include "FileWatcher.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+void FileWatcher::Initialize()
+{
+#if defined(__linux__)
+    _inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotifyDescriptor < 0)
+    {
+        spdlog::warn("App: inotify is not available, polling file timestamps instead");
+    }
+#endif
+
+    _lastPollTime = FrameClock::now();
+}
+
+void FileWatcher::Destroy()
+{
+#if defined(__linux__)
+    if (_inotifyDescriptor >= 0)
+    {
+        close(_inotifyDescriptor);
+        _inotifyDescriptor = -1;
+    }
+#endif
+
+    _watchedDirectories.clear();
+    _watchedFiles.clear();
+    _lastWriteTimes.clear();
+}
+
+void FileWatcher::Watch(const std::filesystem::path& filePath)
+{
+    auto key = GetKey(filePath);
+    if (!_watchedFiles.insert(key).second)
+    {
+        return;
+    }
+
+    std::error_code errorCode;
+    _lastWriteTimes[key] = std::filesystem::last_write_time(key, errorCode);
+
+#if defined(__linux__)
+    if (_inotifyDescriptor >= 0)
+    {
+        auto directoryPath = std::filesystem::path(key).parent_path();
+        auto watchDescriptor = inotify_add_watch(_inotifyDescriptor, directoryPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watchDescriptor < 0)
+        {
+            spdlog::warn("App: Unable to watch {}", directoryPath.string());
+            return;
+        }
+
+        _watchedDirectories[watchDescriptor] = directoryPath;
+    }
+#endif
+}
+
+std::vector<std::filesystem::path> FileWatcher::Poll()
+{
+    return _inotifyDescriptor >= 0
+        ? PollInotify()
+        : PollTimestamps();
+}
+
+std::string FileWatcher::GetKey(const std::filesystem::path& filePath)
+{
+    return std::filesystem::absolute(filePath).lexically_normal().string();
+}
+
+std::vector<std::filesystem::path> FileWatcher::PollInotify()
+{
+    std::vector<std::filesystem::path> changedFiles;
+
+#if defined(__linux__)
+    alignas(inotify_event) char buffer[4096];
+    while (true)
+    {
+        auto readSize = read(_inotifyDescriptor, buffer, sizeof(buffer));
+        if (readSize <= 0)
+        {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < readSize;)
+        {
+            auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            auto watchedDirectory = _watchedDirectories.find(event->wd);
+            if (event->len == 0 || watchedDirectory == _watchedDirectories.end())
+            {
+                continue;
+            }
+
+            auto key = (watchedDirectory->second / event->name).string();
+            if (_watchedFiles.contains(key) && std::find(changedFiles.begin(), changedFiles.end(), key) == changedFiles.end())
+            {
+                changedFiles.emplace_back(key);
+            }
+        }
+    }
+#endif
+
+    return changedFiles;
+}
+
+std::vector<std::filesystem::path> FileWatcher::PollTimestamps()
+{
+    std::vector<std::filesystem::path> changedFiles;
+
+    auto now = FrameClock::now();
+    if (MillisecondsBetween(_lastPollTime, now) < PollingIntervalMilliseconds)
+    {
+        return changedFiles;
+    }
+
+    _lastPollTime = now;
+    for (auto& [key, lastWriteTime] : _lastWriteTimes)
+    {
+        std::error_code errorCode;
+        auto writeTime = std::filesystem::last_write_time(key, errorCode);
+        if (!errorCode && writeTime != lastWriteTime)
+        {
+            lastWriteTime = writeTime;
+            changedFiles.emplace_back(key);
+        }
+    }
+
+    return changedFiles;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "FrameStatistics.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Reports files which changed on disk. Uses inotify on the directories of the watched files,
+// so editors replacing a file on save are caught as well, and falls back to polling timestamps.
+class FileWatcher
+{
+public:
+    void Initialize();
+    void Destroy();
+
+    void Watch(const std::filesystem::path& filePath);
+    std::vector<std::filesystem::path> Poll();
+
+    static std::string GetKey(const std::filesystem::path& filePath);
+
+private:
+    static constexpr double PollingIntervalMilliseconds = 250.0;
+
+    std::vector<std::filesystem::path> PollInotify();
+    std::vector<std::filesystem::path> PollTimestamps();
+
+    int32_t _inotifyDescriptor = -1;
+    std::unordered_map<int32_t, std::filesystem::path> _watchedDirectories;
+    std::unordered_set<std::string> _watchedFiles;
+
+    std::unordered_map<std::string, std::filesystem::file_time_type> _lastWriteTimes;
+    FrameClock::time_point _lastPollTime;
+};
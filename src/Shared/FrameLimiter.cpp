@@ -0,0 +1,65 @@
+#include "FrameLimiter.hpp"
+
+#include <cmath>
+#include <thread>
+
+void FrameLimiter::SetTargetFrameRate(double framesPerSecond)
+{
+    _targetFrameDuration = framesPerSecond > 0.0
+        ? std::chrono::duration_cast<FrameClock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond))
+        : FrameClock::duration::zero();
+    _nextFrameTime = {};
+}
+
+bool FrameLimiter::IsEnabled() const
+{
+    return _targetFrameDuration > FrameClock::duration::zero();
+}
+
+void FrameLimiter::WaitForNextFrame()
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    auto now = FrameClock::now();
+    if (_nextFrameTime == FrameClock::time_point() || now > _nextFrameTime + _targetFrameDuration)
+    {
+        // first frame, or we fell behind by more than a frame, start pacing from here instead of racing to catch up
+        _nextFrameTime = now;
+    }
+    else
+    {
+        SleepUntil(_nextFrameTime);
+    }
+
+    _nextFrameTime += _targetFrameDuration;
+}
+
+void FrameLimiter::SleepUntil(FrameClock::time_point deadline)
+{
+    while (true)
+    {
+        auto sleepStartTime = FrameClock::now();
+        auto remainingSeconds = std::chrono::duration<double>(deadline - sleepStartTime).count();
+        if (remainingSeconds <= _sleepEstimateInSeconds)
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        auto observedSeconds = std::chrono::duration<double>(FrameClock::now() - sleepStartTime).count();
+        _sleepCount++;
+        auto delta = observedSeconds - _sleepMeanInSeconds;
+        _sleepMeanInSeconds += delta / static_cast<double>(_sleepCount);
+        _sleepVarianceSum += delta * (observedSeconds - _sleepMeanInSeconds);
+        _sleepEstimateInSeconds = _sleepMeanInSeconds + std::sqrt(_sleepVarianceSum / static_cast<double>(_sleepCount - 1));
+    }
+
+    while (FrameClock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+}
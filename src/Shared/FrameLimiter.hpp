@@ -0,0 +1,27 @@
+#pragma once
+
+#include "FrameStatistics.hpp"
+
+#include <cstdint>
+
+class FrameLimiter
+{
+public:
+    void SetTargetFrameRate(double framesPerSecond);
+    bool IsEnabled() const;
+
+    void WaitForNextFrame();
+
+private:
+    void SleepUntil(FrameClock::time_point deadline);
+
+    FrameClock::duration _targetFrameDuration = {};
+    FrameClock::time_point _nextFrameTime = {};
+
+    // running mean and deviation of how long a 1ms sleep really takes,
+    // we only sleep while more than mean + deviation is left and spin for the rest
+    double _sleepEstimateInSeconds = 0.005;
+    double _sleepMeanInSeconds = 0.005;
+    double _sleepVarianceSum = 0.0;
+    uint64_t _sleepCount = 1;
+};
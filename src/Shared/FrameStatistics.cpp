@@ -0,0 +1,187 @@
+#include "FrameStatistics.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+
+RollingHistogram::RollingHistogram(size_t capacity)
+    : _capacity(capacity)
+{
+    _samples.reserve(capacity);
+}
+
+void RollingHistogram::Add(double value)
+{
+    if (_samples.size() < _capacity)
+    {
+        _samples.push_back(value);
+    }
+    else
+    {
+        _samples[_nextSample] = value;
+    }
+
+    _nextSample = (_nextSample + 1) % _capacity;
+    _totalCount++;
+}
+
+void RollingHistogram::Clear()
+{
+    _samples.clear();
+    _nextSample = 0;
+    _totalCount = 0;
+}
+
+HistogramSummary RollingHistogram::GetSummary() const
+{
+    HistogramSummary summary = {};
+    if (_samples.empty())
+    {
+        return summary;
+    }
+
+    auto sortedSamples = _samples;
+    std::sort(sortedSamples.begin(), sortedSamples.end());
+
+    auto percentile = [&](double fraction)
+    {
+        auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sortedSamples.size())));
+        return sortedSamples[std::clamp<size_t>(rank, 1, sortedSamples.size()) - 1];
+    };
+
+    double sum = 0.0;
+    for (auto sample : sortedSamples)
+    {
+        sum += sample;
+    }
+
+    summary.Count = _totalCount;
+    summary.Mean = sum / static_cast<double>(sortedSamples.size());
+    summary.P50 = percentile(0.50);
+    summary.P95 = percentile(0.95);
+    summary.P99 = percentile(0.99);
+    summary.Max = sortedSamples.back();
+    return summary;
+}
+
+std::string_view GetFrameTimingStageName(FrameTimingStage stage)
+{
+    switch (stage)
+    {
+        case FrameTimingStage::Poll: return "Poll";
+        case FrameTimingStage::Update: return "Update";
+        case FrameTimingStage::Render: return "Render";
+        case FrameTimingStage::Swap: return "Swap";
+        case FrameTimingStage::Wait: return "Wait";
+        case FrameTimingStage::Frame: return "Frame";
+        case FrameTimingStage::Gpu: return "Gpu";
+        default: return "Unknown";
+    }
+}
+
+void FrameStatistics::Record(FrameTimingStage stage, double milliseconds)
+{
+    _histograms[static_cast<size_t>(stage)].Add(milliseconds);
+}
+
+void FrameStatistics::Clear()
+{
+    for (auto& histogram : _histograms)
+    {
+        histogram.Clear();
+    }
+}
+
+const RollingHistogram& FrameStatistics::GetHistogram(FrameTimingStage stage) const
+{
+    return _histograms[static_cast<size_t>(stage)];
+}
+
+HistogramSummary FrameStatistics::GetSummary(FrameTimingStage stage) const
+{
+    return GetHistogram(stage).GetSummary();
+}
+
+void FrameStatistics::LogSummary() const
+{
+    for (uint32_t stageIndex = 0; stageIndex < static_cast<uint32_t>(FrameTimingStage::Count); stageIndex++)
+    {
+        auto stage = static_cast<FrameTimingStage>(stageIndex);
+        auto summary = GetSummary(stage);
+        if (summary.Count == 0)
+        {
+            continue;
+        }
+
+        spdlog::info("Stats: {:<6} p50 {:.3f}ms p95 {:.3f}ms p99 {:.3f}ms max {:.3f}ms ({} samples)",
+            GetFrameTimingStageName(stage),
+            summary.P50,
+            summary.P95,
+            summary.P99,
+            summary.Max,
+            summary.Count);
+    }
+}
+
+bool FrameStatistics::WriteToFile(std::string_view filePath) const
+{
+    std::ofstream file(std::string(filePath), std::ios::trunc);
+    if (!file.is_open())
+    {
+        spdlog::error("Stats: Unable to open {} for writing", filePath);
+        return false;
+    }
+
+    auto isCsv = filePath.ends_with(".csv");
+    if (isCsv)
+    {
+        file << "stage,count,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+    }
+    else
+    {
+        file << "{\n  \"stages\": {";
+    }
+
+    auto isFirstStage = true;
+    for (uint32_t stageIndex = 0; stageIndex < static_cast<uint32_t>(FrameTimingStage::Count); stageIndex++)
+    {
+        auto stage = static_cast<FrameTimingStage>(stageIndex);
+        auto summary = GetSummary(stage);
+        if (isCsv)
+        {
+            file << std::format("{},{},{:.6f},{:.6f},{:.6f},{:.6f},{:.6f}\n",
+                GetFrameTimingStageName(stage),
+                summary.Count,
+                summary.Mean,
+                summary.P50,
+                summary.P95,
+                summary.P99,
+                summary.Max);
+        }
+        else
+        {
+            file << std::format("{}\n    \"{}\": {{ \"count\": {}, \"mean_ms\": {:.6f}, \"p50_ms\": {:.6f}, \"p95_ms\": {:.6f}, \"p99_ms\": {:.6f}, \"max_ms\": {:.6f} }}",
+                isFirstStage ? "" : ",",
+                GetFrameTimingStageName(stage),
+                summary.Count,
+                summary.Mean,
+                summary.P50,
+                summary.P95,
+                summary.P99,
+                summary.Max);
+        }
+
+        isFirstStage = false;
+    }
+
+    if (!isCsv)
+    {
+        file << "\n  }\n}\n";
+    }
+
+    spdlog::info("Stats: Written to {}", filePath);
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using FrameClock = std::chrono::steady_clock;
+
+inline double MillisecondsBetween(FrameClock::time_point start, FrameClock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+struct RenderCounters
+{
+    uint64_t DrawCalls = 0;
+    uint64_t UploadedBytes = 0;
+};
+
+struct HistogramSummary
+{
+    uint64_t Count = 0;
+    double Mean = 0.0;
+    double P50 = 0.0;
+    double P95 = 0.0;
+    double P99 = 0.0;
+    double Max = 0.0;
+};
+
+class RollingHistogram
+{
+public:
+    explicit RollingHistogram(size_t capacity = 4096);
+
+    void Add(double value);
+    void Clear();
+
+    HistogramSummary GetSummary() const;
+
+private:
+    std::vector<double> _samples;
+    size_t _capacity = 0;
+    size_t _nextSample = 0;
+    uint64_t _totalCount = 0;
+};
+
+enum class FrameTimingStage : uint32_t
+{
+    Poll,
+    Update,
+    Render,
+    Swap,
+    Wait,
+    Frame,
+    Gpu,
+    Count
+};
+
+std::string_view GetFrameTimingStageName(FrameTimingStage stage);
+
+class FrameStatistics
+{
+public:
+    void Record(FrameTimingStage stage, double milliseconds);
+    void Clear();
+
+    const RollingHistogram& GetHistogram(FrameTimingStage stage) const;
+    HistogramSummary GetSummary(FrameTimingStage stage) const;
+
+    void LogSummary() const;
+    bool WriteToFile(std::string_view filePath) const;
+
+private:
+    std::array<RollingHistogram, static_cast<size_t>(FrameTimingStage::Count)> _histograms;
+};
@@ -0,0 +1,116 @@
+#include "FreeListAllocator.hpp"
+
+void FreeListAllocator::Reset(uint64_t capacity)
+{
+    Reset(capacity, 0);
+}
+
+void FreeListAllocator::Reset(uint64_t capacity, uint64_t usedSize)
+{
+    _freeBlocksByOffset.clear();
+    _freeBlocksBySize.clear();
+    _capacity = capacity;
+    _freeSize = 0;
+
+    if (usedSize < capacity)
+    {
+        AddFreeBlock(usedSize, capacity - usedSize);
+    }
+}
+
+std::optional<uint64_t> FreeListAllocator::Allocate(uint64_t size)
+{
+    if (size == 0)
+    {
+        return std::nullopt;
+    }
+
+    auto bestFit = _freeBlocksBySize.lower_bound(size);
+    if (bestFit == _freeBlocksBySize.end())
+    {
+        return std::nullopt;
+    }
+
+    auto offset = bestFit->second;
+    auto blockSize = bestFit->first;
+    RemoveFreeBlock(_freeBlocksByOffset.find(offset));
+
+    if (blockSize > size)
+    {
+        AddFreeBlock(offset + size, blockSize - size);
+    }
+
+    return offset;
+}
+
+void FreeListAllocator::Free(uint64_t offset, uint64_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    auto next = _freeBlocksByOffset.lower_bound(offset);
+    if (next != _freeBlocksByOffset.end() && offset + size == next->first)
+    {
+        size += next->second;
+        RemoveFreeBlock(next);
+    }
+
+    next = _freeBlocksByOffset.lower_bound(offset);
+    if (next != _freeBlocksByOffset.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            size += previous->second;
+            RemoveFreeBlock(previous);
+        }
+    }
+
+    AddFreeBlock(offset, size);
+}
+
+uint64_t FreeListAllocator::GetCapacity() const
+{
+    return _capacity;
+}
+
+uint64_t FreeListAllocator::GetFreeSize() const
+{
+    return _freeSize;
+}
+
+uint64_t FreeListAllocator::GetLargestFreeBlockSize() const
+{
+    return _freeBlocksBySize.empty() ? 0 : _freeBlocksBySize.rbegin()->first;
+}
+
+size_t FreeListAllocator::GetFreeBlockCount() const
+{
+    return _freeBlocksByOffset.size();
+}
+
+void FreeListAllocator::AddFreeBlock(uint64_t offset, uint64_t size)
+{
+    _freeBlocksByOffset.emplace(offset, size);
+    _freeBlocksBySize.emplace(size, offset);
+    _freeSize += size;
+}
+
+void FreeListAllocator::RemoveFreeBlock(std::map<uint64_t, uint64_t>::iterator freeBlock)
+{
+    auto [first, last] = _freeBlocksBySize.equal_range(freeBlock->second);
+    for (auto sizeEntry = first; sizeEntry != last; ++sizeEntry)
+    {
+        if (sizeEntry->second == freeBlock->first)
+        {
+            _freeBlocksBySize.erase(sizeEntry);
+            break;
+        }
+    }
+
+    _freeSize -= freeBlock->second;
+    _freeBlocksByOffset.erase(freeBlock);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+// Hands out ranges of an abstract [0, capacity) space, e.g. vertices or indices of a buffer.
+// Free blocks are kept by offset for coalescing and by size for best fit lookups.
+class FreeListAllocator
+{
+public:
+    void Reset(uint64_t capacity);
+    void Reset(uint64_t capacity, uint64_t usedSize);
+
+    std::optional<uint64_t> Allocate(uint64_t size);
+    void Free(uint64_t offset, uint64_t size);
+
+    uint64_t GetCapacity() const;
+    uint64_t GetFreeSize() const;
+    uint64_t GetLargestFreeBlockSize() const;
+    size_t GetFreeBlockCount() const;
+
+private:
+    void AddFreeBlock(uint64_t offset, uint64_t size);
+    void RemoveFreeBlock(std::map<uint64_t, uint64_t>::iterator freeBlock);
+
+    std::map<uint64_t, uint64_t> _freeBlocksByOffset;
+    std::multimap<uint64_t, uint64_t> _freeBlocksBySize;
+    uint64_t _capacity = 0;
+    uint64_t _freeSize = 0;
+};
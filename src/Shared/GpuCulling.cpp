@@ -0,0 +1,258 @@
+#include "GpuCulling.hpp"
+#include "DrawBatcher.hpp"
+#include "Profiling.hpp"
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <format>
+
+static void SetBufferLabel(uint32_t buffer, const std::string& label)
+{
+    glObjectLabel(GL_BUFFER, buffer, static_cast<int32_t>(label.size()), label.data());
+}
+
+bool GpuCulling::IsSupported()
+{
+    return GLAD_GL_VERSION_4_6 != 0 || GLAD_GL_ARB_indirect_parameters != 0;
+}
+
+bool GpuCulling::Initialize(
+    std::string_view label,
+    uint32_t maxObjectCount)
+{
+    if (maxObjectCount == 0)
+    {
+        spdlog::error("GpuCulling: {} needs room for at least one object", label);
+        return false;
+    }
+
+    _maxObjectCount = maxObjectCount;
+    _objectCount = 0;
+
+    glCreateBuffers(1, &_objectBuffer);
+    SetBufferLabel(_objectBuffer, std::format("CullingObjects_{}", label));
+    glNamedBufferStorage(_objectBuffer, static_cast<size_t>(maxObjectCount) * sizeof(CullingObject), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    glCreateBuffers(1, &_commandBuffer);
+    SetBufferLabel(_commandBuffer, std::format("CulledDrawCommands_{}", label));
+    glNamedBufferStorage(_commandBuffer, static_cast<size_t>(maxObjectCount) * sizeof(DrawElementsIndirectCommand), nullptr, 0);
+
+    glCreateBuffers(1, &_drawCountBuffer);
+    SetBufferLabel(_drawCountBuffer, std::format("CulledDrawCount_{}", label));
+    glNamedBufferStorage(_drawCountBuffer, sizeof(uint32_t), nullptr, 0);
+
+    // one count per frame in flight, the CPU only ever reads slots whose fence has signaled
+    auto readbackFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &_readbackBuffer);
+    SetBufferLabel(_readbackBuffer, std::format("CulledDrawCountReadback_{}", label));
+    glNamedBufferStorage(_readbackBuffer, FramesInFlight * sizeof(uint32_t), nullptr, readbackFlags);
+
+    _readbackData = static_cast<const uint32_t*>(glMapNamedBufferRange(_readbackBuffer, 0, FramesInFlight * sizeof(uint32_t), readbackFlags));
+    if (_readbackData == nullptr)
+    {
+        spdlog::error("GpuCulling: Unable to map the readback buffer of {}", label);
+        Destroy();
+        return false;
+    }
+
+    _pendingReadbacks = {};
+    _currentReadback = 0;
+    _statistics = {};
+
+    return true;
+}
+
+void GpuCulling::Destroy()
+{
+    for (auto& pendingReadback : _pendingReadbacks)
+    {
+        if (pendingReadback.Fence != nullptr)
+        {
+            glDeleteSync(pendingReadback.Fence);
+        }
+
+        pendingReadback = {};
+    }
+
+    if (_readbackBuffer != 0 && _readbackData != nullptr)
+    {
+        glUnmapNamedBuffer(_readbackBuffer);
+    }
+
+    auto buffers = std::to_array<uint32_t*>({ &_objectBuffer, &_commandBuffer, &_drawCountBuffer, &_readbackBuffer });
+    for (auto buffer : buffers)
+    {
+        if (*buffer != 0)
+        {
+            glDeleteBuffers(1, buffer);
+            *buffer = 0;
+        }
+    }
+
+    _readbackData = nullptr;
+    _maxObjectCount = 0;
+    _objectCount = 0;
+}
+
+void GpuCulling::SetObjects(std::span<const CullingObject> objects)
+{
+    if (objects.size() > _maxObjectCount)
+    {
+        spdlog::warn("GpuCulling: {} objects given, only the first {} are culled", objects.size(), _maxObjectCount);
+        objects = objects.first(_maxObjectCount);
+    }
+
+    _objectCount = static_cast<uint32_t>(objects.size());
+    if (_objectCount > 0)
+    {
+        glNamedBufferSubData(_objectBuffer, 0, objects.size_bytes(), objects.data());
+    }
+}
+
+void GpuCulling::Cull(
+    StateCache& stateCache,
+    const Program& cullProgram,
+    uint32_t instanceBuffer,
+    const std::array<glm::vec4, 6>& frustumPlanes)
+{
+    ZoneScopedN("GpuCulling::Cull");
+
+    CollectResults();
+
+    glClearNamedBufferSubData(_drawCountBuffer, GL_R32UI, 0, sizeof(uint32_t), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    glProgramUniform4fv(cullProgram.ComputeShader, 0, static_cast<int32_t>(frustumPlanes.size()), &frustumPlanes[0].x);
+    glProgramUniform1ui(cullProgram.ComputeShader, 6, _objectCount);
+
+    stateCache.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instanceBuffer);
+    stateCache.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _objectBuffer);
+    stateCache.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, _commandBuffer);
+    stateCache.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, _drawCountBuffer);
+    stateCache.BindProgramPipeline(cullProgram.Id);
+    glDispatchCompute((_objectCount + WorkGroupSize - 1) / WorkGroupSize, 1, 1);
+
+    // the commands and the count are consumed as indirect parameters and copied for the readback
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    auto& pendingReadback = _pendingReadbacks[_currentReadback];
+    if (pendingReadback.Fence != nullptr)
+    {
+        // the GPU is more than FramesInFlight frames behind, rather drop the count than stall
+        glDeleteSync(pendingReadback.Fence);
+        _statistics.DroppedReadbackCount++;
+    }
+
+    glCopyNamedBufferSubData(_drawCountBuffer, _readbackBuffer, 0, _currentReadback * sizeof(uint32_t), sizeof(uint32_t));
+    pendingReadback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pendingReadback.ObjectCount = _objectCount;
+
+    _currentReadback = (_currentReadback + 1) % FramesInFlight;
+}
+
+void GpuCulling::Draw(
+    StateCache& stateCache,
+    uint32_t primitiveType)
+{
+    stateCache.BindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer);
+    stateCache.BindBuffer(GL_PARAMETER_BUFFER, _drawCountBuffer);
+    if (GLAD_GL_VERSION_4_6 != 0)
+    {
+        glMultiDrawElementsIndirectCount(primitiveType, GL_UNSIGNED_INT, nullptr, 0, static_cast<int32_t>(_objectCount), 0);
+    }
+    else
+    {
+        glMultiDrawElementsIndirectCountARB(primitiveType, GL_UNSIGNED_INT, nullptr, 0, static_cast<int32_t>(_objectCount), 0);
+    }
+}
+
+const GpuCullingStatistics& GpuCulling::GetStatistics() const
+{
+    return _statistics;
+}
+
+void GpuCulling::ResetStatistics()
+{
+    // counts still in flight belong to whatever was culled before
+    for (auto& pendingReadback : _pendingReadbacks)
+    {
+        if (pendingReadback.Fence != nullptr)
+        {
+            glDeleteSync(pendingReadback.Fence);
+        }
+
+        pendingReadback = {};
+    }
+
+    _statistics = {};
+}
+
+std::array<glm::vec4, 6> GpuCulling::ExtractFrustumPlanes(const glm::mat4& viewProjection)
+{
+    // Gribb/Hartmann, every plane is the last row of the matrix plus or minus one of the others
+    auto getRow = [&](int32_t rowIndex)
+    {
+        return glm::vec4(viewProjection[0][rowIndex], viewProjection[1][rowIndex], viewProjection[2][rowIndex], viewProjection[3][rowIndex]);
+    };
+
+    auto row0 = getRow(0);
+    auto row1 = getRow(1);
+    auto row2 = getRow(2);
+    auto row3 = getRow(3);
+
+    auto frustumPlanes = std::to_array<glm::vec4>(
+    {
+        row3 + row0,
+        row3 - row0,
+        row3 + row1,
+        row3 - row1,
+        row3 + row2,
+        row3 - row2
+    });
+
+    for (auto& frustumPlane : frustumPlanes)
+    {
+        auto length = std::sqrt(frustumPlane.x * frustumPlane.x + frustumPlane.y * frustumPlane.y + frustumPlane.z * frustumPlane.z);
+        if (length > 0.0f)
+        {
+            frustumPlane = glm::vec4(frustumPlane.x / length, frustumPlane.y / length, frustumPlane.z / length, frustumPlane.w / length);
+        }
+    }
+
+    return frustumPlanes;
+}
+
+void GpuCulling::CollectResults()
+{
+    // oldest readback first, a later one can't be done while an earlier one isn't
+    for (uint32_t offset = 0; offset < FramesInFlight; offset++)
+    {
+        auto readbackIndex = (_currentReadback + offset) % FramesInFlight;
+        auto& pendingReadback = _pendingReadbacks[readbackIndex];
+        if (pendingReadback.Fence == nullptr)
+        {
+            continue;
+        }
+
+        auto waitResult = glClientWaitSync(pendingReadback.Fence, 0, 0);
+        if (waitResult == GL_TIMEOUT_EXPIRED)
+        {
+            break;
+        }
+
+        glDeleteSync(pendingReadback.Fence);
+        pendingReadback.Fence = nullptr;
+
+        if (waitResult == GL_WAIT_FAILED)
+        {
+            spdlog::error("GpuCulling: Waiting for readback {} failed", readbackIndex);
+            continue;
+        }
+
+        auto visibleCount = _readbackData[readbackIndex];
+        _statistics.VisibleCount += visibleCount;
+        _statistics.CulledCount += pendingReadback.ObjectCount - visibleCount;
+        _statistics.ReadbackCount++;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Program.hpp"
+#include "StateCache.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+struct __GLsync;
+
+// std430 layout of one entry in the object buffer the cull shader reads, the bounding
+// sphere is in the object's local space and gets moved by its InstanceData like the mesh
+struct CullingObject
+{
+    glm::vec4 BoundingSphere;
+    uint32_t IndexCount;
+    uint32_t FirstIndex;
+    int32_t BaseVertex;
+    uint32_t Padding;
+};
+
+struct GpuCullingStatistics
+{
+    uint64_t VisibleCount = 0;
+    uint64_t CulledCount = 0;
+    uint64_t ReadbackCount = 0;
+    uint64_t DroppedReadbackCount = 0;
+};
+
+// Frustum culls objects in a compute shader, which appends a DrawElementsIndirectCommand
+// for every survivor and counts them with an atomic, then draws them all with one
+// glMultiDrawElementsIndirectCount. The count is copied into a persistently mapped buffer
+// and read back FramesInFlight frames late, so the statistics never wait on the GPU.
+//
+// The cull program binds instances to SSBO 0, objects to 1, commands to 2 and the draw
+// count to 3, takes the 6 frustum planes at uniform location 0 and the object count at 6.
+// Both are set on its compute stage every Cull, so pass the Program a hot reload handed to
+// Application::OnProgramReloaded, the stage of an older copy is deleted.
+class GpuCulling
+{
+public:
+    // glMultiDrawElementsIndirectCount is core in 4.6, older contexts need ARB_indirect_parameters
+    static bool IsSupported();
+
+    bool Initialize(
+        std::string_view label,
+        uint32_t maxObjectCount);
+    void Destroy();
+
+    void SetObjects(std::span<const CullingObject> objects);
+
+    void Cull(
+        StateCache& stateCache,
+        const Program& cullProgram,
+        uint32_t instanceBuffer,
+        const std::array<glm::vec4, 6>& frustumPlanes);
+    void Draw(
+        StateCache& stateCache,
+        uint32_t primitiveType);
+
+    const GpuCullingStatistics& GetStatistics() const;
+    // also forgets the readbacks still in flight, call it when the objects change meaning
+    void ResetStatistics();
+
+    // planes point inwards and are normalized, so dot(plane, vec4(center, 1)) is a distance
+    static std::array<glm::vec4, 6> ExtractFrustumPlanes(const glm::mat4& viewProjection);
+
+private:
+    static constexpr uint32_t FramesInFlight = 4;
+    static constexpr uint32_t WorkGroupSize = 64;
+
+    struct PendingReadback
+    {
+        __GLsync* Fence = nullptr;
+        uint32_t ObjectCount = 0;
+    };
+
+    void CollectResults();
+
+    uint32_t _objectBuffer = 0;
+    uint32_t _commandBuffer = 0;
+    uint32_t _drawCountBuffer = 0;
+    uint32_t _readbackBuffer = 0;
+    const uint32_t* _readbackData = nullptr;
+    uint32_t _maxObjectCount = 0;
+    uint32_t _objectCount = 0;
+
+    std::array<PendingReadback, FramesInFlight> _pendingReadbacks = {};
+    uint32_t _currentReadback = 0;
+    GpuCullingStatistics _statistics;
+};
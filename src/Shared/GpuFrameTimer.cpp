@@ -0,0 +1,101 @@
+#include "GpuFrameTimer.hpp"
+#include "FrameStatistics.hpp"
+
+#include <glad/glad.h>
+
+void GpuFrameTimer::Initialize()
+{
+    for (auto& timestampPair : _timestampPairs)
+    {
+        glCreateQueries(GL_TIMESTAMP, 1, &timestampPair.BeginQuery);
+        glCreateQueries(GL_TIMESTAMP, 1, &timestampPair.EndQuery);
+        timestampPair.IsPending = false;
+    }
+
+    _currentPair = 0;
+    _isInitialized = true;
+}
+
+void GpuFrameTimer::Destroy()
+{
+    if (!_isInitialized)
+    {
+        return;
+    }
+
+    for (auto& timestampPair : _timestampPairs)
+    {
+        glDeleteQueries(1, &timestampPair.BeginQuery);
+        glDeleteQueries(1, &timestampPair.EndQuery);
+        timestampPair = {};
+    }
+
+    _isInitialized = false;
+}
+
+void GpuFrameTimer::BeginFrame()
+{
+    if (!_isInitialized)
+    {
+        return;
+    }
+
+    auto& timestampPair = _timestampPairs[_currentPair];
+    if (timestampPair.IsPending)
+    {
+        // the GPU is more than FramesInFlight frames behind, rather drop the sample than stall
+        _droppedFrameCount++;
+    }
+
+    glQueryCounter(timestampPair.BeginQuery, GL_TIMESTAMP);
+    timestampPair.IsPending = false;
+}
+
+void GpuFrameTimer::EndFrame(FrameStatistics& frameStatistics)
+{
+    if (!_isInitialized)
+    {
+        return;
+    }
+
+    auto& timestampPair = _timestampPairs[_currentPair];
+    glQueryCounter(timestampPair.EndQuery, GL_TIMESTAMP);
+    timestampPair.IsPending = true;
+
+    _currentPair = (_currentPair + 1) % FramesInFlight;
+
+    CollectResults(frameStatistics);
+}
+
+uint64_t GpuFrameTimer::GetDroppedFrameCount() const
+{
+    return _droppedFrameCount;
+}
+
+void GpuFrameTimer::CollectResults(FrameStatistics& frameStatistics)
+{
+    // oldest pending pair first, so samples end up in submission order
+    for (uint32_t offset = 0; offset < FramesInFlight; offset++)
+    {
+        auto& timestampPair = _timestampPairs[(_currentPair + offset) % FramesInFlight];
+        if (!timestampPair.IsPending)
+        {
+            continue;
+        }
+
+        int32_t isAvailable = GL_FALSE;
+        glGetQueryObjectiv(timestampPair.EndQuery, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (isAvailable == GL_FALSE)
+        {
+            break;
+        }
+
+        uint64_t beginTimestamp = 0;
+        uint64_t endTimestamp = 0;
+        glGetQueryObjectui64v(timestampPair.BeginQuery, GL_QUERY_RESULT, &beginTimestamp);
+        glGetQueryObjectui64v(timestampPair.EndQuery, GL_QUERY_RESULT, &endTimestamp);
+        timestampPair.IsPending = false;
+
+        frameStatistics.Record(FrameTimingStage::Gpu, static_cast<double>(endTimestamp - beginTimestamp) / 1'000'000.0);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+class FrameStatistics;
+
+class GpuFrameTimer
+{
+public:
+    void Initialize();
+    void Destroy();
+
+    void BeginFrame();
+    void EndFrame(FrameStatistics& frameStatistics);
+
+    uint64_t GetDroppedFrameCount() const;
+
+private:
+    // results are read back this many frames late, so reading them never waits on the GPU
+    static constexpr uint32_t FramesInFlight = 4;
+
+    struct TimestampPair
+    {
+        uint32_t BeginQuery = 0;
+        uint32_t EndQuery = 0;
+        bool IsPending = false;
+    };
+
+    void CollectResults(FrameStatistics& frameStatistics);
+
+    std::array<TimestampPair, FramesInFlight> _timestampPairs = {};
+    uint32_t _currentPair = 0;
+    uint64_t _droppedFrameCount = 0;
+    bool _isInitialized = false;
+};
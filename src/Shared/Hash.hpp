@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+constexpr uint64_t Fnv1aOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t Fnv1aPrime = 1099511628211ull;
+
+inline uint64_t HashBytes(
+    const void* data,
+    size_t size,
+    uint64_t hash = Fnv1aOffsetBasis)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t byteIndex = 0; byteIndex < size; byteIndex++)
+    {
+        hash ^= bytes[byteIndex];
+        hash *= Fnv1aPrime;
+    }
+
+    return hash;
+}
+
+inline uint64_t HashString(
+    std::string_view text,
+    uint64_t hash = Fnv1aOffsetBasis)
+{
+    return HashBytes(text.data(), text.size(), hash);
+}
+
+template<typename T>
+inline uint64_t HashValue(
+    const T& value,
+    uint64_t hash = Fnv1aOffsetBasis)
+{
+    return HashBytes(&value, sizeof(T), hash);
+}
@@ -1,8 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 #include <vector>
-#include <string_view>
 
 struct InputLayoutElement
 {
@@ -10,8 +10,13 @@ struct InputLayoutElement
     uint32_t ComponentCount;
     uint32_t ComponentType;
     bool IsNormalized = false;
+    // set up with glVertexArrayAttribIFormat, the shader reads ints instead of converted floats
+    bool IsInteger = false;
     uint32_t Offset;
     uint32_t BindingIndex;
+    // the binding advances once per this many instances, 0 advances per vertex.
+    // Elements sharing a binding have to agree on it
+    uint32_t Divisor = 0;
 };
 
 struct InputLayout
@@ -25,5 +30,5 @@ struct InputLayout
     void Bind();
 
     uint32_t Id = 0;
-    std::string_view Label;
+    std::string Label;
 };
\ No newline at end of file
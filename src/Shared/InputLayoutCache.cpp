@@ -0,0 +1,111 @@
+#include "InputLayoutCache.hpp"
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+InputLayout InputLayoutCache::GetOrCreate(
+    std::string_view label,
+    std::span<const InputLayoutElement> elements)
+{
+    // the order elements are declared in does not change the vertex format
+    std::vector<InputLayoutElement> format(elements.begin(), elements.end());
+    std::sort(format.begin(), format.end(), [](const InputLayoutElement& left, const InputLayoutElement& right)
+    {
+        return left.AttributeIndex < right.AttributeIndex;
+    });
+
+    auto cachedInputLayout = _inputLayouts.find(format);
+    if (cachedInputLayout != _inputLayouts.end())
+    {
+        spdlog::debug("App: Reusing input layout {} for {}", cachedInputLayout->second.Label, label);
+        _statistics.ReusedCount++;
+        return cachedInputLayout->second;
+    }
+
+    InputLayout inputLayout = {};
+    inputLayout.Label = label;
+    glCreateVertexArrays(1, &inputLayout.Id);
+    glObjectLabel(GL_VERTEX_ARRAY, inputLayout.Id, static_cast<int32_t>(inputLayout.Label.size()), inputLayout.Label.data());
+
+    for (auto& element : format)
+    {
+        glEnableVertexArrayAttrib(inputLayout.Id, element.AttributeIndex);
+        if (element.IsInteger)
+        {
+            glVertexArrayAttribIFormat(inputLayout.Id, element.AttributeIndex, element.ComponentCount, element.ComponentType, element.Offset);
+        }
+        else
+        {
+            glVertexArrayAttribFormat(inputLayout.Id, element.AttributeIndex, element.ComponentCount, element.ComponentType, element.IsNormalized, element.Offset);
+        }
+
+        glVertexArrayAttribBinding(inputLayout.Id, element.AttributeIndex, element.BindingIndex);
+        glVertexArrayBindingDivisor(inputLayout.Id, element.BindingIndex, element.Divisor);
+    }
+
+    _statistics.CreatedCount++;
+    _inputLayouts.emplace(std::move(format), inputLayout);
+    return inputLayout;
+}
+
+void InputLayoutCache::Destroy()
+{
+    for (auto& [_, inputLayout] : _inputLayouts)
+    {
+        glDeleteVertexArrays(1, &inputLayout.Id);
+    }
+
+    _inputLayouts.clear();
+}
+
+size_t InputLayoutCache::GetInputLayoutCount() const
+{
+    return _inputLayouts.size();
+}
+
+const InputLayoutCacheStatistics& InputLayoutCache::GetStatistics() const
+{
+    return _statistics;
+}
+
+size_t InputLayoutCache::FormatHash::operator()(const std::vector<InputLayoutElement>& elements) const
+{
+    // FNV-1a over the fields, not the bytes, padding after IsInteger is uninitialized
+    uint64_t hash = 14695981039346656037ull;
+    auto combine = [&hash](uint32_t value)
+    {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    for (auto& element : elements)
+    {
+        combine(element.AttributeIndex);
+        combine(element.ComponentCount);
+        combine(element.ComponentType);
+        combine(element.IsNormalized ? 1 : 0);
+        combine(element.IsInteger ? 1 : 0);
+        combine(element.Offset);
+        combine(element.BindingIndex);
+        combine(element.Divisor);
+    }
+
+    return static_cast<size_t>(hash);
+}
+
+bool InputLayoutCache::FormatEqual::operator()(const std::vector<InputLayoutElement>& left, const std::vector<InputLayoutElement>& right) const
+{
+    return std::equal(left.begin(), left.end(), right.begin(), right.end(), [](const InputLayoutElement& leftElement, const InputLayoutElement& rightElement)
+    {
+        return leftElement.AttributeIndex == rightElement.AttributeIndex &&
+               leftElement.ComponentCount == rightElement.ComponentCount &&
+               leftElement.ComponentType == rightElement.ComponentType &&
+               leftElement.IsNormalized == rightElement.IsNormalized &&
+               leftElement.IsInteger == rightElement.IsInteger &&
+               leftElement.Offset == rightElement.Offset &&
+               leftElement.BindingIndex == rightElement.BindingIndex &&
+               leftElement.Divisor == rightElement.Divisor;
+    });
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "InputLayout.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct InputLayoutCacheStatistics
+{
+    uint64_t CreatedCount = 0;
+    uint64_t ReusedCount = 0;
+};
+
+// Hands out one VAO per distinct vertex format. Buffer bindings and binding divisors live in the VAO
+// as well, so everyone sharing a layout has to (re)bind their buffers before drawing with it.
+class InputLayoutCache
+{
+public:
+    InputLayout GetOrCreate(
+        std::string_view label,
+        std::span<const InputLayoutElement> elements);
+    void Destroy();
+
+    size_t GetInputLayoutCount() const;
+    const InputLayoutCacheStatistics& GetStatistics() const;
+
+private:
+    struct FormatHash
+    {
+        size_t operator()(const std::vector<InputLayoutElement>& elements) const;
+    };
+
+    struct FormatEqual
+    {
+        bool operator()(const std::vector<InputLayoutElement>& left, const std::vector<InputLayoutElement>& right) const;
+    };
+
+    std::unordered_map<std::vector<InputLayoutElement>, InputLayout, FormatHash, FormatEqual> _inputLayouts;
+    InputLayoutCacheStatistics _statistics;
+};
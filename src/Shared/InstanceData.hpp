@@ -0,0 +1,21 @@
+#pragma once
+
+#include "VertexComponents.hpp"
+
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+
+// One copy of a mesh. Laid out like the std430 array element, so the same buffer feeds per instance
+// attributes through a binding divisor as well as a storage buffer indexed by gl_InstanceID
+struct alignas(16) InstanceData
+{
+    // xyz translation, w uniform scale
+    glm::vec4 TranslationScale;
+    // quaternion, w is the real part
+    glm::vec4 Rotation;
+    PackedColorUnorm8 Color;
+    uint32_t MaterialIndex;
+};
+
+static_assert(sizeof(InstanceData) == 48);
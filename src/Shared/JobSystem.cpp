@@ -0,0 +1,301 @@
+#include "JobSystem.hpp"
+#include "Profiling.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <format>
+
+struct Job
+{
+    std::function<void()> Function;
+    JobCounter* Counter = nullptr;
+};
+
+static thread_local uint32_t t_threadIndex = UINT32_MAX;
+static thread_local const JobSystem* t_jobSystem = nullptr;
+
+bool JobCounter::IsDone() const
+{
+    return _value.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::~JobSystem()
+{
+    Destroy();
+}
+
+void JobSystem::Initialize(uint32_t workerThreadCount)
+{
+    if (workerThreadCount == 0)
+    {
+        workerThreadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    // thread 0 is whoever initializes us, usually the main thread
+    auto threadCount = workerThreadCount + 1;
+    for (uint32_t threadIndex = 0; threadIndex < threadCount; threadIndex++)
+    {
+        _deques.push_back(std::make_unique<WorkStealingDeque<Job>>(DequeCapacity));
+    }
+
+    t_threadIndex = 0;
+    t_jobSystem = this;
+    _isRunning = true;
+
+    for (uint32_t threadIndex = 1; threadIndex < threadCount; threadIndex++)
+    {
+        _workerThreads.emplace_back(&JobSystem::WorkerMain, this, threadIndex);
+    }
+
+    spdlog::info("App: Job system running with {} worker threads", workerThreadCount);
+}
+
+void JobSystem::Destroy()
+{
+    if (!_isRunning)
+    {
+        return;
+    }
+
+    _isRunning = false;
+    _queuedJobCount.fetch_add(1);
+    _queuedJobCount.notify_all();
+
+    for (auto& workerThread : _workerThreads)
+    {
+        workerThread.join();
+    }
+
+    _workerThreads.clear();
+    for (auto& deque : _deques)
+    {
+        while (auto job = deque->Steal())
+        {
+            delete job;
+        }
+    }
+
+    _deques.clear();
+    for (auto job : _sharedJobs)
+    {
+        delete job;
+    }
+
+    _sharedJobs.clear();
+    _queuedJobCount = 0;
+    if (t_jobSystem == this)
+    {
+        t_threadIndex = NoThreadIndex;
+        t_jobSystem = nullptr;
+    }
+}
+
+void JobSystem::Run(
+    std::function<void()> function,
+    JobCounter* counter)
+{
+    if (counter != nullptr)
+    {
+        counter->_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Submit(new Job{ .Function = std::move(function), .Counter = counter });
+}
+
+void JobSystem::RunAfter(
+    JobCounter& dependency,
+    std::function<void()> function,
+    JobCounter* counter)
+{
+    if (counter != nullptr)
+    {
+        counter->_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto job = new Job{ .Function = std::move(function), .Counter = counter };
+    {
+        std::lock_guard lock(dependency._continuationMutex);
+        if (!dependency.IsDone())
+        {
+            dependency._continuations.push_back(job);
+            return;
+        }
+    }
+
+    Submit(job);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    ZoneScopedN("JobSystem::Wait");
+
+    auto threadIndex = GetCurrentThreadIndex();
+    while (!counter.IsDone())
+    {
+        if (!TryRunJob(threadIndex))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::lock_guard lock(counter._continuationMutex);
+}
+
+void JobSystem::ParallelFor(
+    uint32_t count,
+    uint32_t chunkSize,
+    const std::function<void(uint32_t, uint32_t)>& function)
+{
+    chunkSize = std::max(chunkSize, 1u);
+    if (count <= chunkSize || _deques.empty())
+    {
+        function(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (uint32_t begin = chunkSize; begin < count; begin += chunkSize)
+    {
+        auto end = std::min(begin + chunkSize, count);
+        Run([&function, begin, end]()
+        {
+            function(begin, end);
+        }, &counter);
+    }
+
+    // the calling thread takes the first chunk instead of idling
+    function(0, chunkSize);
+    Wait(counter);
+}
+
+uint32_t JobSystem::GetThreadCount() const
+{
+    return static_cast<uint32_t>(_deques.size());
+}
+
+void JobSystem::Submit(Job* job)
+{
+    // count first, a thief may run the job before we get to notify
+    _queuedJobCount.fetch_add(1, std::memory_order_release);
+
+    auto threadIndex = GetCurrentThreadIndex();
+    if (threadIndex == NoThreadIndex || !_deques[threadIndex]->Push(job))
+    {
+        std::lock_guard lock(_sharedJobMutex);
+        _sharedJobs.push_back(job);
+    }
+
+    _queuedJobCount.notify_one();
+}
+
+bool JobSystem::TryRunJob(uint32_t threadIndex)
+{
+    Job* job = nullptr;
+    if (threadIndex != NoThreadIndex)
+    {
+        job = _deques[threadIndex]->Pop();
+    }
+
+    // steal round robin, starting next to ourselves so thieves spread over the victims
+    auto threadCount = static_cast<uint32_t>(_deques.size());
+    for (uint32_t victimOffset = 1; job == nullptr && victimOffset <= threadCount; victimOffset++)
+    {
+        auto victimIndex = (threadIndex == NoThreadIndex ? victimOffset : threadIndex + victimOffset) % threadCount;
+        if (victimIndex != threadIndex)
+        {
+            job = _deques[victimIndex]->Steal();
+        }
+    }
+
+    if (job == nullptr)
+    {
+        std::lock_guard lock(_sharedJobMutex);
+        if (!_sharedJobs.empty())
+        {
+            job = _sharedJobs.back();
+            _sharedJobs.pop_back();
+        }
+    }
+
+    if (job == nullptr)
+    {
+        return false;
+    }
+
+    _queuedJobCount.fetch_sub(1, std::memory_order_acq_rel);
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(Job* job)
+{
+    job->Function();
+    Signal(job->Counter);
+    delete job;
+}
+
+void JobSystem::Signal(JobCounter* counter)
+{
+    if (counter == nullptr)
+    {
+        return;
+    }
+
+    // the last decrement happens under the lock, Wait takes it as well before it returns,
+    // so the counter cannot go out of scope while we still touch it
+    std::vector<Job*> continuations;
+    auto value = counter->_value.load(std::memory_order_acquire);
+    while (true)
+    {
+        if (value == 1)
+        {
+            std::lock_guard lock(counter->_continuationMutex);
+            if (counter->_value.compare_exchange_strong(value, 0, std::memory_order_acq_rel))
+            {
+                continuations.swap(counter->_continuations);
+                break;
+            }
+        }
+        else if (counter->_value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel))
+        {
+            return;
+        }
+    }
+
+    for (auto continuation : continuations)
+    {
+        Submit(continuation);
+    }
+}
+
+void JobSystem::WorkerMain(uint32_t threadIndex)
+{
+    t_threadIndex = threadIndex;
+    t_jobSystem = this;
+
+    auto threadName = std::format("Worker {}", threadIndex);
+    tracy::SetThreadName(threadName.c_str());
+
+    while (_isRunning.load(std::memory_order_acquire))
+    {
+        if (!TryRunJob(threadIndex))
+        {
+            // sleep until something gets queued, queued jobs may sit in a deque we failed to steal from
+            auto queuedJobCount = _queuedJobCount.load(std::memory_order_acquire);
+            if (queuedJobCount == 0)
+            {
+                _queuedJobCount.wait(0, std::memory_order_acquire);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+uint32_t JobSystem::GetCurrentThreadIndex() const
+{
+    return t_jobSystem == this ? t_threadIndex : NoThreadIndex;
+}
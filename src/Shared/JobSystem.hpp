@@ -0,0 +1,78 @@
+#pragma once
+
+#include "WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Job;
+
+// Counts outstanding jobs. Jobs started with RunAfter wait for it to reach zero.
+// Only let it go out of scope after JobSystem::Wait returned for it.
+class JobCounter
+{
+public:
+    bool IsDone() const;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> _value = 0;
+    std::mutex _continuationMutex;
+    std::vector<Job*> _continuations;
+};
+
+// Fixed pool of workers, one per core with the main thread taking part as well. Every thread
+// owns a deque, idle threads steal from the others. Waiting threads run jobs until the counter is done.
+class JobSystem
+{
+public:
+    ~JobSystem();
+
+    void Initialize(uint32_t workerThreadCount = 0);
+    void Destroy();
+
+    void Run(
+        std::function<void()> function,
+        JobCounter* counter = nullptr);
+    void RunAfter(
+        JobCounter& dependency,
+        std::function<void()> function,
+        JobCounter* counter = nullptr);
+    void Wait(JobCounter& counter);
+
+    // calls function(begin, end) on chunks of [0, count) and returns once all of them ran
+    void ParallelFor(
+        uint32_t count,
+        uint32_t chunkSize,
+        const std::function<void(uint32_t, uint32_t)>& function);
+
+    uint32_t GetThreadCount() const;
+
+private:
+    static constexpr uint32_t DequeCapacity = 4096;
+    static constexpr uint32_t NoThreadIndex = UINT32_MAX;
+
+    void Submit(Job* job);
+    bool TryRunJob(uint32_t threadIndex);
+    void Execute(Job* job);
+    void Signal(JobCounter* counter);
+    void WorkerMain(uint32_t threadIndex);
+
+    uint32_t GetCurrentThreadIndex() const;
+
+    std::vector<std::unique_ptr<WorkStealingDeque<Job>>> _deques;
+    std::vector<std::thread> _workerThreads;
+
+    // jobs submitted from threads which are not part of the pool, or from full deques
+    std::mutex _sharedJobMutex;
+    std::vector<Job*> _sharedJobs;
+
+    std::atomic<uint32_t> _queuedJobCount = 0;
+    std::atomic<bool> _isRunning = false;
+};
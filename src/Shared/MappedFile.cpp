@@ -0,0 +1,128 @@
+#include "MappedFile.hpp"
+
+#include <format>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+#if defined(_WIN32)
+        _fileHandle = std::exchange(other._fileHandle, nullptr);
+        _mappingHandle = std::exchange(other._mappingHandle, nullptr);
+#endif
+    }
+
+    return *this;
+}
+
+std::expected<void, std::string> MappedFile::Open(const std::filesystem::path& filePath)
+{
+    Close();
+
+#if defined(_WIN32)
+    _fileHandle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        _fileHandle = nullptr;
+        return std::unexpected(std::format("Io: Unable to open {}", filePath.string()));
+    }
+
+    LARGE_INTEGER fileSize = {};
+    GetFileSizeEx(_fileHandle, &fileSize);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+    _mappingHandle = _size > 0 ? CreateFileMappingW(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    auto mapping = _mappingHandle != nullptr ? MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (mapping == nullptr)
+    {
+        Close();
+        return std::unexpected(std::format("Io: Unable to map {}", filePath.string()));
+    }
+#else
+    auto fileDescriptor = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0)
+    {
+        return std::unexpected(std::format("Io: Unable to open {}", filePath.string()));
+    }
+
+    struct stat fileStatus = {};
+    fstat(fileDescriptor, &fileStatus);
+    _size = static_cast<size_t>(fileStatus.st_size);
+
+    // the mapping keeps its own reference to the file
+    auto mapping = _size > 0 ? mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) : MAP_FAILED;
+    close(fileDescriptor);
+    if (mapping == MAP_FAILED)
+    {
+        _size = 0;
+        return std::unexpected(std::format("Io: Unable to map {}", filePath.string()));
+    }
+#endif
+
+    _data = static_cast<const std::byte*>(mapping);
+    return {};
+}
+
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+    }
+
+    if (_mappingHandle != nullptr)
+    {
+        CloseHandle(_mappingHandle);
+        _mappingHandle = nullptr;
+    }
+
+    if (_fileHandle != nullptr)
+    {
+        CloseHandle(_fileHandle);
+        _fileHandle = nullptr;
+    }
+#else
+    if (_data != nullptr)
+    {
+        munmap(const_cast<std::byte*>(_data), _size);
+    }
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
+
+bool MappedFile::IsOpen() const
+{
+    return _data != nullptr;
+}
+
+std::span<const std::byte> MappedFile::GetData() const
+{
+    return std::span(_data, _size);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+
+// Read only memory mapping of a whole file, mmap on POSIX and a file mapping on Windows.
+// Owns the mapping, so it can be moved but not copied.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    std::expected<void, std::string> Open(const std::filesystem::path& filePath);
+    void Close();
+    bool IsOpen() const;
+
+    std::span<const std::byte> GetData() const;
+
+private:
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+
+#if defined(_WIN32)
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif
+};
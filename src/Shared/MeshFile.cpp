@@ -0,0 +1,147 @@
+#include "MeshFile.hpp"
+
+#include <algorithm>
+#include <format>
+#include <utility>
+
+MeshFile::MeshFile(MeshFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MeshFile& MeshFile::operator=(MeshFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        // moving the mapping and the vector keeps their memory where it is, so _data stays valid
+        _file = std::move(other._file);
+        _storage = std::move(other._storage);
+        _data = std::exchange(other._data, {});
+        _header = std::exchange(other._header, {});
+        other.Close();
+    }
+
+    return *this;
+}
+
+std::expected<void, std::string> MeshFile::Open(
+    const std::filesystem::path& filePath,
+    const AssetPack* assetPack)
+{
+    Close();
+
+    if (auto packEntry = assetPack != nullptr ? assetPack->Find(filePath) : nullptr; packEntry != nullptr)
+    {
+        auto packedData = assetPack->Read(*packEntry, _storage);
+        if (!packedData.has_value())
+        {
+            return std::unexpected(packedData.error());
+        }
+
+        _data = packedData.value();
+    }
+    else
+    {
+        auto openResult = _file.Open(filePath);
+        if (!openResult.has_value())
+        {
+            return openResult;
+        }
+
+        _data = _file.GetData();
+    }
+
+    if (_data.size() >= sizeof(_header))
+    {
+        std::copy_n(_data.data(), sizeof(_header), reinterpret_cast<std::byte*>(&_header));
+    }
+
+    auto indexDataSize = static_cast<uint64_t>(_header.IndexCount) * _header.IndexSize;
+    auto isValid =
+        _header.Magic == MeshFileMagic &&
+        _header.Version == MeshFileVersion &&
+        _header.VertexStride == GetMeshVertexStride(_header.VertexFormat) &&
+        (_header.IndexSize == 2 || _header.IndexSize == 4) &&
+        _header.SubmeshOffset % alignof(MeshSubmesh) == 0 &&
+        _header.IndexOffset % _header.IndexSize == 0 &&
+        _header.SubmeshOffset + static_cast<uint64_t>(_header.SubmeshCount) * sizeof(MeshSubmesh) <= _data.size() &&
+        _header.VertexOffset + static_cast<uint64_t>(_header.VertexCount) * _header.VertexStride <= _data.size() &&
+        _header.IndexOffset + indexDataSize <= _data.size();
+    if (!isValid)
+    {
+        Close();
+        return std::unexpected(std::format("Io: {} is not a version {} mesh file", filePath.string(), MeshFileVersion));
+    }
+
+    auto submeshes = GetSubmeshes();
+    auto isSubmeshOutOfBounds = std::any_of(submeshes.begin(), submeshes.end(), [&](const MeshSubmesh& submesh)
+    {
+        return static_cast<uint64_t>(submesh.FirstIndex) + submesh.IndexCount > _header.IndexCount;
+    });
+    if (isSubmeshOutOfBounds)
+    {
+        Close();
+        return std::unexpected(std::format("Io: Mesh file {} has submeshes outside its indices", filePath.string()));
+    }
+
+    // checked once here, so nobody drawing or reading the indices later reads past the vertices
+    auto isIndexOutOfBounds = [&](auto indices)
+    {
+        return std::any_of(indices.begin(), indices.end(), [&](uint32_t index)
+        {
+            return index >= _header.VertexCount;
+        });
+    };
+
+    auto indexData = GetIndexData();
+    if (_header.IndexSize == 4
+        ? isIndexOutOfBounds(std::span(reinterpret_cast<const uint32_t*>(indexData.data()), _header.IndexCount))
+        : isIndexOutOfBounds(std::span(reinterpret_cast<const uint16_t*>(indexData.data()), _header.IndexCount)))
+    {
+        Close();
+        return std::unexpected(std::format("Io: Mesh file {} has indices outside its vertices", filePath.string()));
+    }
+
+    return {};
+}
+
+void MeshFile::Close()
+{
+    _file.Close();
+    _storage.clear();
+    _data = {};
+    _header = {};
+}
+
+const MeshFileHeader& MeshFile::GetHeader() const
+{
+    return _header;
+}
+
+std::span<const MeshSubmesh> MeshFile::GetSubmeshes() const
+{
+    return std::span(reinterpret_cast<const MeshSubmesh*>(_data.data() + _header.SubmeshOffset), _header.SubmeshCount);
+}
+
+std::span<const std::byte> MeshFile::GetVertexData() const
+{
+    return _data.subspan(_header.VertexOffset, static_cast<size_t>(_header.VertexCount) * _header.VertexStride);
+}
+
+std::span<const std::byte> MeshFile::GetIndexData() const
+{
+    return _data.subspan(_header.IndexOffset, static_cast<size_t>(_header.IndexCount) * _header.IndexSize);
+}
+
+std::span<const uint32_t> MeshFile::GetIndices(std::vector<uint32_t>& storage) const
+{
+    auto indexData = GetIndexData();
+    if (_header.IndexSize == 4)
+    {
+        return std::span(reinterpret_cast<const uint32_t*>(indexData.data()), _header.IndexCount);
+    }
+
+    auto indices = std::span(reinterpret_cast<const uint16_t*>(indexData.data()), _header.IndexCount);
+    storage.assign(indices.begin(), indices.end());
+    return storage;
+}
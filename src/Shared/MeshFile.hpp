@@ -0,0 +1,116 @@
+#pragma once
+
+#include "AssetPack.hpp"
+#include "MappedFile.hpp"
+#include "VertexPositionColor.hpp"
+#include "VertexPositionColorQuantized.hpp"
+#include "VertexPositionNormalUv.hpp"
+#include "VertexPositionNormalUvQuantized.hpp"
+#include "VertexPositionUv.hpp"
+#include "VertexPositionUvQuantized.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+// .mesh layout: header, submeshes, vertices, indices, each section on a MeshFileAlignment boundary.
+// Vertices are interleaved exactly like the vertex struct of VertexFormat so they upload as they are.
+// Written by tools/MeshConverter.
+constexpr uint32_t MeshFileMagic = 0x4D53474F; // "OGSM"
+constexpr uint32_t MeshFileVersion = 2;
+constexpr uint64_t MeshFileAlignment = 16;
+
+enum class MeshVertexFormat : uint32_t
+{
+    PositionUv,
+    PositionColor,
+    // snorm16 positions, see PositionOffset and PositionScale
+    PositionUvQuantized,
+    PositionColorQuantized,
+    PositionNormalUv,
+    // snorm16 positions, octahedral normals
+    PositionNormalUvQuantized
+};
+
+struct MeshFileHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    MeshVertexFormat VertexFormat;
+    uint32_t VertexStride;
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+    // 2 or 4 bytes
+    uint32_t IndexSize;
+    uint32_t SubmeshCount;
+    float BoundsMin[3];
+    float BoundsMax[3];
+    // position = PositionOffset + PositionScale * stored position, 0 and 1 for float formats
+    float PositionOffset[3];
+    float PositionScale[3];
+    uint64_t SubmeshOffset;
+    uint64_t VertexOffset;
+    uint64_t IndexOffset;
+};
+
+struct MeshSubmesh
+{
+    uint32_t FirstIndex;
+    uint32_t IndexCount;
+    uint32_t MaterialIndex;
+    uint32_t Reserved;
+};
+
+static_assert(sizeof(MeshFileHeader) == 104);
+static_assert(sizeof(MeshSubmesh) == 16);
+
+constexpr uint32_t GetMeshVertexStride(MeshVertexFormat vertexFormat)
+{
+    switch (vertexFormat)
+    {
+        case MeshVertexFormat::PositionUv: return sizeof(VertexPositionUv);
+        case MeshVertexFormat::PositionColor: return sizeof(VertexPositionColor);
+        case MeshVertexFormat::PositionUvQuantized: return sizeof(VertexPositionUvQuantized);
+        case MeshVertexFormat::PositionColorQuantized: return sizeof(VertexPositionColorQuantized);
+        case MeshVertexFormat::PositionNormalUv: return sizeof(VertexPositionNormalUv);
+        case MeshVertexFormat::PositionNormalUvQuantized: return sizeof(VertexPositionNormalUvQuantized);
+    }
+
+    return 0;
+}
+
+// Views a .mesh in place, either in its own mapping or inside the asset pack. Like its
+// mapping it can be moved but not copied, the views move along with it.
+class MeshFile
+{
+public:
+    MeshFile() = default;
+    ~MeshFile() = default;
+
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+    MeshFile(MeshFile&& other) noexcept;
+    MeshFile& operator=(MeshFile&& other) noexcept;
+
+    std::expected<void, std::string> Open(
+        const std::filesystem::path& filePath,
+        const AssetPack* assetPack = nullptr);
+    void Close();
+
+    const MeshFileHeader& GetHeader() const;
+    std::span<const MeshSubmesh> GetSubmeshes() const;
+    std::span<const std::byte> GetVertexData() const;
+    std::span<const std::byte> GetIndexData() const;
+    // 16 bit indices get widened into storage, 32 bit ones are viewed in place
+    std::span<const uint32_t> GetIndices(std::vector<uint32_t>& storage) const;
+
+private:
+    MappedFile _file;
+    std::vector<std::byte> _storage;
+    std::span<const std::byte> _data;
+    MeshFileHeader _header = {};
+};
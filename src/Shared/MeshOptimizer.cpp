@@ -0,0 +1,429 @@
+#include "MeshOptimizer.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace
+{
+    constexpr uint32_t ForsythCacheSize = 32;
+    constexpr float ForsythCacheDecayPower = 1.5f;
+    constexpr float ForsythLastTriangleScore = 0.75f;
+    constexpr float ForsythValenceBoostScale = 2.0f;
+    constexpr float ForsythValenceBoostPower = 0.5f;
+
+    struct Float3
+    {
+        float X;
+        float Y;
+        float Z;
+    };
+
+    Float3 ReadPosition(
+        std::span<const std::byte> vertices,
+        uint32_t vertexStride,
+        uint32_t vertexIndex)
+    {
+        Float3 position = {};
+        std::memcpy(&position, vertices.data() + static_cast<size_t>(vertexIndex) * vertexStride, sizeof(position));
+        return position;
+    }
+
+    float GetForsythVertexScore(
+        int32_t cachePosition,
+        uint32_t remainingValence)
+    {
+        if (remainingValence == 0)
+        {
+            // no triangle left to use it, never worth picking
+            return -1.0f;
+        }
+
+        auto score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+            {
+                // the triangle just drawn, a fixed score so strips do not get favoured too much
+                score = ForsythLastTriangleScore;
+            }
+            else
+            {
+                auto scaler = 1.0f / (ForsythCacheSize - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, ForsythCacheDecayPower);
+            }
+        }
+
+        // vertices with few triangles left get a boost, that clears out lone triangles early
+        return score + ForsythValenceBoostScale * std::pow(static_cast<float>(remainingValence), -ForsythValenceBoostPower);
+    }
+}
+
+VertexCacheStatistics SimulateVertexCache(
+    std::span<const uint32_t> indices,
+    uint32_t vertexCount,
+    uint32_t cacheSize)
+{
+    // timestamps instead of a queue, a vertex is cached while fewer than cacheSize misses happened since it was added
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    uint32_t timestamp = cacheSize + 1;
+
+    VertexCacheStatistics statistics = {};
+    for (auto index : indices)
+    {
+        if (timestamp - cacheTimestamps[index] > cacheSize)
+        {
+            cacheTimestamps[index] = timestamp++;
+            statistics.TransformedVertexCount++;
+        }
+    }
+
+    auto triangleCount = indices.size() / 3;
+    statistics.Acmr = triangleCount > 0 ? static_cast<float>(statistics.TransformedVertexCount) / triangleCount : 0.0f;
+    statistics.Atvr = vertexCount > 0 ? static_cast<float>(statistics.TransformedVertexCount) / vertexCount : 0.0f;
+    return statistics;
+}
+
+std::vector<uint32_t> GenerateVertexRemap(
+    std::span<const std::byte> vertices,
+    uint32_t vertexStride,
+    uint32_t& uniqueVertexCount)
+{
+    auto vertexCount = static_cast<uint32_t>(vertices.size() / vertexStride);
+    auto getVertex = [&](uint32_t vertexIndex)
+    {
+        return std::string_view(reinterpret_cast<const char*>(vertices.data()) + static_cast<size_t>(vertexIndex) * vertexStride, vertexStride);
+    };
+
+    // bitwise equality, welding never changes what gets rendered
+    std::unordered_map<std::string_view, uint32_t> uniqueVertices;
+    uniqueVertices.reserve(vertexCount);
+
+    std::vector<uint32_t> remap(vertexCount);
+    uniqueVertexCount = 0;
+    for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+    {
+        auto [uniqueVertex, isNew] = uniqueVertices.emplace(getVertex(vertexIndex), uniqueVertexCount);
+        remap[vertexIndex] = uniqueVertex->second;
+        if (isNew)
+        {
+            uniqueVertexCount++;
+        }
+    }
+
+    return remap;
+}
+
+std::vector<std::byte> RemapVertices(
+    std::span<const std::byte> vertices,
+    uint32_t vertexStride,
+    std::span<const uint32_t> remap,
+    uint32_t uniqueVertexCount)
+{
+    std::vector<std::byte> remappedVertices(static_cast<size_t>(uniqueVertexCount) * vertexStride);
+    for (uint32_t vertexIndex = 0; vertexIndex < remap.size(); vertexIndex++)
+    {
+        std::memcpy(
+            remappedVertices.data() + static_cast<size_t>(remap[vertexIndex]) * vertexStride,
+            vertices.data() + static_cast<size_t>(vertexIndex) * vertexStride,
+            vertexStride);
+    }
+
+    return remappedVertices;
+}
+
+void RemapIndices(
+    std::span<uint32_t> indices,
+    std::span<const uint32_t> remap)
+{
+    for (auto& index : indices)
+    {
+        index = remap[index];
+    }
+}
+
+void OptimizeVertexCache(
+    std::span<uint32_t> indices,
+    uint32_t vertexCount)
+{
+    auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    // triangles adjacent to each vertex, packed into one array
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+    for (auto index : indices)
+    {
+        triangleOffsets[index + 1]++;
+    }
+
+    std::partial_sum(triangleOffsets.begin(), triangleOffsets.end(), triangleOffsets.begin());
+    std::vector<uint32_t> adjacentTriangles(indices.size());
+    std::vector<uint32_t> remainingValences(vertexCount, 0);
+    for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++)
+    {
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            auto vertexIndex = indices[triangleIndex * 3 + corner];
+            adjacentTriangles[triangleOffsets[vertexIndex] + remainingValences[vertexIndex]++] = triangleIndex;
+        }
+    }
+
+    std::vector<int32_t> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+    {
+        vertexScores[vertexIndex] = GetForsythVertexScore(-1, remainingValences[vertexIndex]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> isTriangleEmitted(triangleCount, false);
+    for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++)
+    {
+        triangleScores[triangleIndex] =
+            vertexScores[indices[triangleIndex * 3 + 0]] +
+            vertexScores[indices[triangleIndex * 3 + 1]] +
+            vertexScores[indices[triangleIndex * 3 + 2]];
+    }
+
+    // the extra 3 slots take the vertices pushed out by the triangle just added
+    std::array<uint32_t, ForsythCacheSize + 3> cache = {};
+    uint32_t cacheCount = 0;
+    std::vector<uint32_t> optimizedIndices;
+    optimizedIndices.reserve(indices.size());
+
+    uint32_t nextCandidate = 0;
+    auto bestTriangle = UINT32_MAX;
+    for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        if (bestTriangle == UINT32_MAX)
+        {
+            // nothing in the cache connects to what is left, start over from the highest scoring triangle
+            auto bestScore = -1.0f;
+            for (auto triangleIndex = nextCandidate; triangleIndex < triangleCount; triangleIndex++)
+            {
+                if (!isTriangleEmitted[triangleIndex] && triangleScores[triangleIndex] > bestScore)
+                {
+                    bestScore = triangleScores[triangleIndex];
+                    bestTriangle = triangleIndex;
+                }
+            }
+        }
+
+        isTriangleEmitted[bestTriangle] = true;
+        while (nextCandidate < triangleCount && isTriangleEmitted[nextCandidate])
+        {
+            nextCandidate++;
+        }
+
+        std::array<uint32_t, ForsythCacheSize + 3> newCache = {};
+        uint32_t newCacheCount = 0;
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            auto vertexIndex = indices[bestTriangle * 3 + corner];
+            optimizedIndices.push_back(vertexIndex);
+            newCache[newCacheCount++] = vertexIndex;
+
+            // the emitted triangle no longer counts toward the vertex's valence
+            auto triangles = std::span(adjacentTriangles).subspan(triangleOffsets[vertexIndex], remainingValences[vertexIndex]);
+            auto emittedTriangle = std::find(triangles.begin(), triangles.end(), bestTriangle);
+            std::swap(*emittedTriangle, triangles.back());
+            remainingValences[vertexIndex]--;
+        }
+
+        for (uint32_t cacheIndex = 0; cacheIndex < cacheCount; cacheIndex++)
+        {
+            auto vertexIndex = cache[cacheIndex];
+            if (vertexIndex != newCache[0] && vertexIndex != newCache[1] && vertexIndex != newCache[2])
+            {
+                newCache[newCacheCount++] = vertexIndex;
+            }
+        }
+
+        // rescore everything that was touched, evicted vertices fall back to their uncached score
+        bestTriangle = UINT32_MAX;
+        auto bestScore = -1.0f;
+        for (uint32_t cacheIndex = 0; cacheIndex < newCacheCount; cacheIndex++)
+        {
+            auto vertexIndex = newCache[cacheIndex];
+            auto cachePosition = cacheIndex < ForsythCacheSize ? static_cast<int32_t>(cacheIndex) : -1;
+            cachePositions[vertexIndex] = cachePosition;
+
+            auto score = GetForsythVertexScore(cachePosition, remainingValences[vertexIndex]);
+            auto scoreDelta = score - vertexScores[vertexIndex];
+            vertexScores[vertexIndex] = score;
+
+            for (uint32_t adjacentIndex = 0; adjacentIndex < remainingValences[vertexIndex]; adjacentIndex++)
+            {
+                auto triangleIndex = adjacentTriangles[triangleOffsets[vertexIndex] + adjacentIndex];
+                triangleScores[triangleIndex] += scoreDelta;
+                if (cachePosition >= 0 && triangleScores[triangleIndex] > bestScore)
+                {
+                    bestScore = triangleScores[triangleIndex];
+                    bestTriangle = triangleIndex;
+                }
+            }
+        }
+
+        cache = newCache;
+        cacheCount = std::min(newCacheCount, ForsythCacheSize);
+    }
+
+    std::copy(optimizedIndices.begin(), optimizedIndices.end(), indices.begin());
+}
+
+void OptimizeOverdraw(
+    std::span<uint32_t> indices,
+    std::span<const std::byte> vertices,
+    uint32_t vertexStride)
+{
+    auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    auto vertexCount = static_cast<uint32_t>(vertices.size() / vertexStride);
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    // a cluster ends where the simulated cache restarts, every vertex of the triangle missing it.
+    // Reordering whole clusters keeps the vertex cache hits inside each of them
+    std::vector<uint32_t> clusterStarts;
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    constexpr uint32_t cacheSize = 16;
+    uint32_t timestamp = cacheSize + 1;
+    for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++)
+    {
+        uint32_t missCount = 0;
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            auto vertexIndex = indices[triangleIndex * 3 + corner];
+            if (timestamp - cacheTimestamps[vertexIndex] > cacheSize)
+            {
+                cacheTimestamps[vertexIndex] = timestamp++;
+                missCount++;
+            }
+        }
+
+        if (triangleIndex == 0 || missCount == 3)
+        {
+            clusterStarts.push_back(triangleIndex);
+        }
+    }
+
+    struct Cluster
+    {
+        uint32_t FirstTriangle;
+        uint32_t TriangleCount;
+        float SortKey;
+    };
+
+    std::vector<Cluster> clusters(clusterStarts.size());
+    Float3 meshCentroid = {};
+    float meshArea = 0.0f;
+    std::vector<std::array<float, 7>> clusterSums(clusters.size());
+    for (size_t clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++)
+    {
+        auto& cluster = clusters[clusterIndex];
+        cluster.FirstTriangle = clusterStarts[clusterIndex];
+        cluster.TriangleCount = (clusterIndex + 1 < clusters.size() ? clusterStarts[clusterIndex + 1] : triangleCount) - cluster.FirstTriangle;
+
+        // area weighted centroid and summed normal, the normal length is twice the area
+        auto& sums = clusterSums[clusterIndex];
+        sums = {};
+        for (auto triangleIndex = cluster.FirstTriangle; triangleIndex < cluster.FirstTriangle + cluster.TriangleCount; triangleIndex++)
+        {
+            auto p0 = ReadPosition(vertices, vertexStride, indices[triangleIndex * 3 + 0]);
+            auto p1 = ReadPosition(vertices, vertexStride, indices[triangleIndex * 3 + 1]);
+            auto p2 = ReadPosition(vertices, vertexStride, indices[triangleIndex * 3 + 2]);
+            Float3 edge0 = { p1.X - p0.X, p1.Y - p0.Y, p1.Z - p0.Z };
+            Float3 edge1 = { p2.X - p0.X, p2.Y - p0.Y, p2.Z - p0.Z };
+            Float3 normal = { edge0.Y * edge1.Z - edge0.Z * edge1.Y, edge0.Z * edge1.X - edge0.X * edge1.Z, edge0.X * edge1.Y - edge0.Y * edge1.X };
+            auto area = std::sqrt(normal.X * normal.X + normal.Y * normal.Y + normal.Z * normal.Z) * 0.5f;
+
+            sums[0] += (p0.X + p1.X + p2.X) / 3.0f * area;
+            sums[1] += (p0.Y + p1.Y + p2.Y) / 3.0f * area;
+            sums[2] += (p0.Z + p1.Z + p2.Z) / 3.0f * area;
+            sums[3] += normal.X;
+            sums[4] += normal.Y;
+            sums[5] += normal.Z;
+            sums[6] += area;
+        }
+
+        meshCentroid.X += sums[0];
+        meshCentroid.Y += sums[1];
+        meshCentroid.Z += sums[2];
+        meshArea += sums[6];
+    }
+
+    if (meshArea <= 0.0f)
+    {
+        return;
+    }
+
+    meshCentroid = { meshCentroid.X / meshArea, meshCentroid.Y / meshArea, meshCentroid.Z / meshArea };
+    for (size_t clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++)
+    {
+        auto& sums = clusterSums[clusterIndex];
+        auto area = std::max(sums[6], 1e-20f);
+        Float3 offset = { sums[0] / area - meshCentroid.X, sums[1] / area - meshCentroid.Y, sums[2] / area - meshCentroid.Z };
+        auto normalLength = std::sqrt(sums[3] * sums[3] + sums[4] * sums[4] + sums[5] * sums[5]);
+
+        // how far out the cluster sits along where it faces, the outermost ones occlude the most
+        clusters[clusterIndex].SortKey = normalLength > 0.0f
+            ? (offset.X * sums[3] + offset.Y * sums[4] + offset.Z * sums[5]) / normalLength
+            : 0.0f;
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& left, const Cluster& right)
+    {
+        return left.SortKey > right.SortKey;
+    });
+
+    std::vector<uint32_t> sortedIndices;
+    sortedIndices.reserve(indices.size());
+    for (auto& cluster : clusters)
+    {
+        auto clusterIndices = indices.subspan(cluster.FirstTriangle * 3, cluster.TriangleCount * 3);
+        sortedIndices.insert(sortedIndices.end(), clusterIndices.begin(), clusterIndices.end());
+    }
+
+    std::copy(sortedIndices.begin(), sortedIndices.end(), indices.begin());
+}
+
+std::vector<std::byte> OptimizeVertexFetch(
+    std::span<uint32_t> indices,
+    std::span<const std::byte> vertices,
+    uint32_t vertexStride)
+{
+    auto vertexCount = static_cast<uint32_t>(vertices.size() / vertexStride);
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    uint32_t usedVertexCount = 0;
+    for (auto& index : indices)
+    {
+        if (remap[index] == UINT32_MAX)
+        {
+            remap[index] = usedVertexCount++;
+        }
+
+        index = remap[index];
+    }
+
+    std::vector<std::byte> fetchOrderedVertices(static_cast<size_t>(usedVertexCount) * vertexStride);
+    for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+    {
+        if (remap[vertexIndex] != UINT32_MAX)
+        {
+            std::memcpy(
+                fetchOrderedVertices.data() + static_cast<size_t>(remap[vertexIndex]) * vertexStride,
+                vertices.data() + static_cast<size_t>(vertexIndex) * vertexStride,
+                vertexStride);
+        }
+    }
+
+    return fetchOrderedVertices;
+}
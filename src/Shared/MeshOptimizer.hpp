@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Index and vertex buffer reordering, no GL involved so it runs at load time as well as in
+// tools/MeshConverter. Vertex positions are read from the first 3 floats of every vertex,
+// which is where VertexPositionUv and VertexPositionColor keep them.
+
+struct VertexCacheStatistics
+{
+    uint32_t TransformedVertexCount = 0;
+    // transformed vertices per triangle, 0.5 is the best a regular grid gets, 3 means no reuse
+    float Acmr = 0.0f;
+    // transformed vertices per vertex, 1 means every vertex ran the shader exactly once
+    float Atvr = 0.0f;
+};
+
+// FIFO cache simulation, what the post transform cache of most GPUs behaves like
+VertexCacheStatistics SimulateVertexCache(
+    std::span<const uint32_t> indices,
+    uint32_t vertexCount,
+    uint32_t cacheSize = 16);
+
+// maps every vertex to the first one with the same bytes, returns the remap and the unique count
+std::vector<uint32_t> GenerateVertexRemap(
+    std::span<const std::byte> vertices,
+    uint32_t vertexStride,
+    uint32_t& uniqueVertexCount);
+std::vector<std::byte> RemapVertices(
+    std::span<const std::byte> vertices,
+    uint32_t vertexStride,
+    std::span<const uint32_t> remap,
+    uint32_t uniqueVertexCount);
+void RemapIndices(
+    std::span<uint32_t> indices,
+    std::span<const uint32_t> remap);
+
+// Tom Forsyth's linear-speed vertex cache optimisation, reorders triangles in place
+void OptimizeVertexCache(
+    std::span<uint32_t> indices,
+    uint32_t vertexCount);
+
+// Splits cache optimized triangles into clusters where the cache restarts and draws the outward
+// facing clusters first, so they occlude the rest. Costs a little ACMR, bounded by the clusters.
+void OptimizeOverdraw(
+    std::span<uint32_t> indices,
+    std::span<const std::byte> vertices,
+    uint32_t vertexStride);
+
+// Orders vertices by first use and drops unused ones, rewrites indices and returns the new vertices
+std::vector<std::byte> OptimizeVertexFetch(
+    std::span<uint32_t> indices,
+    std::span<const std::byte> vertices,
+    uint32_t vertexStride);
@@ -0,0 +1,8 @@
+#pragma once
+
+// Tracy needs the GL entry points declared before TracyOpenGL.hpp is included.
+// Every macro in here compiles to nothing unless TRACY_ENABLE is defined.
+#include <glad/glad.h>
+
+#include <tracy/Tracy.hpp>
+#include <tracy/TracyOpenGL.hpp>
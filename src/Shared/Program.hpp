@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Program
+{
+    uint32_t Id = 0;
+    uint32_t VertexShader = 0;
+    uint32_t FragmentShader = 0;
+    uint32_t ComputeShader = 0;
+};
+
+struct ProgramDescription
+{
+    std::string Label;
+    std::string VertexShaderFilePath;
+    std::string FragmentShaderFilePath;
+    // a compute program has only this stage, graphics programs leave it empty
+    std::string ComputeShaderFilePath;
+    // NAME or NAME=VALUE, injected after #version into every stage
+    std::vector<std::string> Defines;
+};
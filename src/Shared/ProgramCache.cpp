@@ -0,0 +1,446 @@
+#include "ProgramCache.hpp"
+#include "Hash.hpp"
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+static std::string_view GetGLString(uint32_t name)
+{
+    auto value = reinterpret_cast<const char*>(glGetString(name));
+    return value != nullptr ? std::string_view(value) : std::string_view();
+}
+
+static std::string GetShaderInfoLog(uint32_t shader)
+{
+    auto infoLogLength = 0;
+    char infoLog[1024];
+    glGetShaderInfoLog(shader, 1024, &infoLogLength, infoLog);
+    return std::string(infoLog, infoLogLength);
+}
+
+static std::string GetProgramInfoLog(uint32_t program)
+{
+    auto infoLogLength = 0;
+    char infoLog[1024];
+    glGetProgramInfoLog(program, 1024, &infoLogLength, infoLog);
+    return std::string(infoLog, infoLogLength);
+}
+
+void ProgramCache::Initialize(const std::filesystem::path& directoryPath)
+{
+    _isParallelCompileSupported = GLAD_GL_KHR_parallel_shader_compile != 0;
+    if (_isParallelCompileSupported)
+    {
+        // let the driver pick how many threads it wants
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+
+    _isSpirvSupported = GLAD_GL_VERSION_4_6 != 0 || GLAD_GL_ARB_gl_spirv != 0;
+
+    _isEnabled = false;
+    if (directoryPath.empty())
+    {
+        return;
+    }
+
+    auto binaryFormatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+    if (binaryFormatCount == 0)
+    {
+        spdlog::info("App: Driver supports no program binary formats, program cache disabled");
+        return;
+    }
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(directoryPath, errorCode);
+    if (errorCode)
+    {
+        spdlog::warn("App: Unable to create program cache directory {}: {}", directoryPath.string(), errorCode.message());
+        return;
+    }
+
+    // binaries are only valid for the exact driver which produced them
+    _driverHash = HashString(GetGLString(GL_VENDOR));
+    _driverHash = HashString(GetGLString(GL_RENDERER), _driverHash);
+    _driverHash = HashString(GetGLString(GL_VERSION), _driverHash);
+    _driverHash = HashString(GetGLString(GL_SHADING_LANGUAGE_VERSION), _driverHash);
+
+    _directoryPath = directoryPath;
+    _isEnabled = true;
+    RemoveStaleFiles();
+}
+
+std::expected<uint32_t, std::string> ProgramCache::CreateShaderProgram(
+    std::string_view label,
+    uint32_t shaderType,
+    std::string_view shaderSource)
+{
+    auto pendingShaderProgram = BeginShaderProgram(label, shaderType, shaderSource);
+    return EndShaderProgram(pendingShaderProgram);
+}
+
+PendingShaderProgram ProgramCache::BeginShaderProgram(
+    std::string_view label,
+    uint32_t shaderType,
+    std::string_view shaderSource)
+{
+    PendingShaderProgram pendingShaderProgram = {};
+    pendingShaderProgram.Label = label;
+    pendingShaderProgram.StartTime = FrameClock::now();
+    pendingShaderProgram.Key = HashString(shaderSource, HashValue(shaderType, _driverHash));
+    if (TryBeginFromCache(pendingShaderProgram))
+    {
+        return pendingShaderProgram;
+    }
+
+    // what glCreateShaderProgramv does, but it links before we could ask for a retrievable binary.
+    // No status is queried here, that would wait for the compiler
+    pendingShaderProgram.Shader = glCreateShader(shaderType);
+    auto shaderContent = shaderSource.data();
+    auto shaderContentLength = static_cast<int32_t>(shaderSource.size());
+    glShaderSource(pendingShaderProgram.Shader, 1, &shaderContent, &shaderContentLength);
+    glCompileShader(pendingShaderProgram.Shader);
+
+    LinkShaderProgram(pendingShaderProgram);
+    return pendingShaderProgram;
+}
+
+PendingShaderProgram ProgramCache::BeginShaderProgram(
+    std::string_view label,
+    uint32_t shaderType,
+    std::span<const char> spirv)
+{
+    PendingShaderProgram pendingShaderProgram = {};
+    pendingShaderProgram.Label = label;
+    pendingShaderProgram.IsSpirv = true;
+    pendingShaderProgram.StartTime = FrameClock::now();
+    // the binary format is part of the key, a SPIR-V build never picks up a binary linked from GLSL
+    pendingShaderProgram.Key = HashBytes(spirv.data(), spirv.size(), HashValue(shaderType, HashValue(GL_SHADER_BINARY_FORMAT_SPIR_V, _driverHash)));
+    if (TryBeginFromCache(pendingShaderProgram))
+    {
+        return pendingShaderProgram;
+    }
+
+    pendingShaderProgram.Shader = glCreateShader(shaderType);
+    glShaderBinary(1, &pendingShaderProgram.Shader, GL_SHADER_BINARY_FORMAT_SPIR_V, spirv.data(), static_cast<int32_t>(spirv.size()));
+    if (GLAD_GL_VERSION_4_6 != 0)
+    {
+        glSpecializeShader(pendingShaderProgram.Shader, "main", 0, nullptr, nullptr);
+    }
+    else
+    {
+        glSpecializeShaderARB(pendingShaderProgram.Shader, "main", 0, nullptr, nullptr);
+    }
+
+    LinkShaderProgram(pendingShaderProgram);
+    return pendingShaderProgram;
+}
+
+bool ProgramCache::IsShaderProgramComplete(const PendingShaderProgram& pendingShaderProgram) const
+{
+    if (pendingShaderProgram.Shader == 0 || !_isParallelCompileSupported)
+    {
+        return true;
+    }
+
+    auto completionStatus = 0;
+    glGetProgramiv(pendingShaderProgram.ShaderProgram, GL_COMPLETION_STATUS_KHR, &completionStatus);
+    return completionStatus == GL_TRUE;
+}
+
+std::expected<uint32_t, std::string> ProgramCache::EndShaderProgram(PendingShaderProgram& pendingShaderProgram)
+{
+    auto shaderProgram = pendingShaderProgram.ShaderProgram;
+    auto& label = pendingShaderProgram.Label;
+
+    if (pendingShaderProgram.Shader != 0)
+    {
+        auto shader = pendingShaderProgram.Shader;
+        pendingShaderProgram.Shader = 0;
+        pendingShaderProgram.ShaderProgram = 0;
+
+        auto compileStatus = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
+        if (compileStatus == GL_FALSE)
+        {
+            auto infoLog = GetShaderInfoLog(shader);
+            glDeleteShader(shader);
+            glDeleteProgram(shaderProgram);
+            return std::unexpected(infoLog);
+        }
+
+        glDetachShader(shaderProgram, shader);
+        glDeleteShader(shader);
+
+        auto linkStatus = 0;
+        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &linkStatus);
+        if (linkStatus == GL_FALSE)
+        {
+            auto infoLog = GetProgramInfoLog(shaderProgram);
+            glDeleteProgram(shaderProgram);
+            return std::unexpected(infoLog);
+        }
+
+        // in a batch this includes time spent waiting on other programs, it is what loading actually costs
+        auto compileMilliseconds = MillisecondsBetween(pendingShaderProgram.StartTime, FrameClock::now());
+        _statistics.MissCount++;
+        _statistics.CompileMilliseconds += compileMilliseconds;
+        if (pendingShaderProgram.IsSpirv)
+        {
+            _statistics.SpirvMissCount++;
+            _statistics.SpirvCompileMilliseconds += compileMilliseconds;
+        }
+
+        if (_isEnabled)
+        {
+            StoreProgram(pendingShaderProgram.Key, shaderProgram, compileMilliseconds);
+        }
+    }
+
+    glObjectLabel(GL_PROGRAM, shaderProgram, static_cast<int32_t>(label.size()), label.data());
+    return shaderProgram;
+}
+
+bool ProgramCache::IsEnabled() const
+{
+    return _isEnabled;
+}
+
+bool ProgramCache::IsParallelCompileSupported() const
+{
+    return _isParallelCompileSupported;
+}
+
+bool ProgramCache::IsSpirvSupported() const
+{
+    return _isSpirvSupported;
+}
+
+const ProgramCacheStatistics& ProgramCache::GetStatistics() const
+{
+    return _statistics;
+}
+
+std::filesystem::path ProgramCache::GetFilePath(uint64_t key) const
+{
+    return _directoryPath / std::format("{:016x}.bin", key);
+}
+
+void ProgramCache::RemoveStaleFiles()
+{
+    struct CacheFile
+    {
+        std::filesystem::path FilePath;
+        std::filesystem::file_time_type WriteTime;
+        uint64_t Size = 0;
+    };
+
+    std::vector<CacheFile> cacheFiles;
+    std::vector<std::filesystem::path> staleFilePaths;
+    uint64_t totalSize = 0;
+    std::error_code errorCode;
+    for (auto& entry : std::filesystem::directory_iterator(_directoryPath, errorCode))
+    {
+        if (!entry.is_regular_file(errorCode))
+        {
+            continue;
+        }
+
+        // binaries of another driver or file version never load again, neither does what an interrupted write left
+        auto isCurrent = entry.path().extension() == ".bin";
+        if (isCurrent)
+        {
+            FileHeader header = {};
+            std::ifstream file(entry.path(), std::ios::binary);
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+            isCurrent = file && header.Magic == FileMagic && header.Version == FileVersion && header.DriverHash == _driverHash;
+        }
+
+        if (!isCurrent)
+        {
+            staleFilePaths.push_back(entry.path());
+            continue;
+        }
+
+        cacheFiles.push_back(
+        {
+            .FilePath = entry.path(),
+            .WriteTime = entry.last_write_time(errorCode),
+            .Size = entry.file_size(errorCode)
+        });
+        totalSize += cacheFiles.back().Size;
+    }
+
+    // hits refresh the write time, so the oldest one is the least recently used
+    std::sort(cacheFiles.begin(), cacheFiles.end(), [](const CacheFile& left, const CacheFile& right)
+    {
+        return left.WriteTime < right.WriteTime;
+    });
+
+    auto outdatedCount = staleFilePaths.size();
+    for (size_t fileIndex = 0; fileIndex < cacheFiles.size(); fileIndex++)
+    {
+        if (cacheFiles.size() - fileIndex <= MaxFileCount && totalSize <= MaxTotalSize)
+        {
+            break;
+        }
+
+        staleFilePaths.push_back(cacheFiles[fileIndex].FilePath);
+        totalSize -= cacheFiles[fileIndex].Size;
+    }
+
+    for (auto& staleFilePath : staleFilePaths)
+    {
+        std::filesystem::remove(staleFilePath, errorCode);
+    }
+
+    if (!staleFilePaths.empty())
+    {
+        spdlog::info(
+            "App: Removed {} outdated and {} least recently used program binaries from {}",
+            outdatedCount,
+            staleFilePaths.size() - outdatedCount,
+            _directoryPath.string());
+    }
+}
+
+bool ProgramCache::TryBeginFromCache(PendingShaderProgram& pendingShaderProgram)
+{
+    if (!_isEnabled)
+    {
+        return false;
+    }
+
+    auto compileMilliseconds = 0.0;
+    pendingShaderProgram.ShaderProgram = TryLoadProgram(pendingShaderProgram.Key, compileMilliseconds);
+    if (pendingShaderProgram.ShaderProgram == 0)
+    {
+        return false;
+    }
+
+    auto loadMilliseconds = MillisecondsBetween(pendingShaderProgram.StartTime, FrameClock::now());
+    _statistics.HitCount++;
+    _statistics.LoadMilliseconds += loadMilliseconds;
+    _statistics.SavedMilliseconds += compileMilliseconds - loadMilliseconds;
+    return true;
+}
+
+void ProgramCache::LinkShaderProgram(PendingShaderProgram& pendingShaderProgram)
+{
+    pendingShaderProgram.ShaderProgram = glCreateProgram();
+    glProgramParameteri(pendingShaderProgram.ShaderProgram, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    if (_isEnabled)
+    {
+        glProgramParameteri(pendingShaderProgram.ShaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    glAttachShader(pendingShaderProgram.ShaderProgram, pendingShaderProgram.Shader);
+    glLinkProgram(pendingShaderProgram.ShaderProgram);
+}
+
+uint32_t ProgramCache::TryLoadProgram(
+    uint64_t key,
+    double& compileMilliseconds)
+{
+    auto filePath = GetFilePath(key);
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return 0;
+    }
+
+    FileHeader header = {};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.Magic != FileMagic || header.Version != FileVersion || header.Key != key || header.DriverHash != _driverHash)
+    {
+        _statistics.RejectedCount++;
+        return 0;
+    }
+
+    std::vector<char> binary(header.BinarySize);
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file)
+    {
+        _statistics.RejectedCount++;
+        return 0;
+    }
+
+    auto shaderProgram = glCreateProgram();
+    glProgramParameteri(shaderProgram, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    glProgramBinary(shaderProgram, header.BinaryFormat, binary.data(), static_cast<int32_t>(binary.size()));
+
+    auto linkStatus = 0;
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &linkStatus);
+    if (linkStatus == GL_FALSE)
+    {
+        // driver update or a different format, the caller compiles from source and overwrites it
+        spdlog::debug("App: Program binary {} was rejected by the driver", filePath.string());
+        glDeleteProgram(shaderProgram);
+        _statistics.RejectedCount++;
+        return 0;
+    }
+
+    // marks it as recently used for RemoveStaleFiles
+    std::error_code errorCode;
+    std::filesystem::last_write_time(filePath, std::filesystem::file_time_type::clock::now(), errorCode);
+
+    compileMilliseconds = header.CompileMilliseconds;
+    return shaderProgram;
+}
+
+void ProgramCache::StoreProgram(
+    uint64_t key,
+    uint32_t program,
+    double compileMilliseconds)
+{
+    auto binarySize = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+    if (binarySize <= 0)
+    {
+        return;
+    }
+
+    std::vector<char> binary(static_cast<size_t>(binarySize));
+    uint32_t binaryFormat = 0;
+    glGetProgramBinary(program, binarySize, &binarySize, &binaryFormat, binary.data());
+
+    FileHeader header =
+    {
+        .Magic = FileMagic,
+        .Version = FileVersion,
+        .Key = key,
+        .DriverHash = _driverHash,
+        .BinaryFormat = binaryFormat,
+        .BinarySize = static_cast<uint32_t>(binarySize),
+        .CompileMilliseconds = compileMilliseconds
+    };
+
+    // write next to the final file and rename, a crash never leaves a truncated binary behind
+    auto filePath = GetFilePath(key);
+    auto temporaryFilePath = filePath;
+    temporaryFilePath += ".tmp";
+    {
+        std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            spdlog::warn("App: Unable to write program binary {}", temporaryFilePath.string());
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), binarySize);
+    }
+
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryFilePath, filePath, errorCode);
+    if (errorCode)
+    {
+        spdlog::warn("App: Unable to store program binary {}: {}", filePath.string(), errorCode.message());
+    }
+}
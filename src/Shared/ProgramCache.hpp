@@ -0,0 +1,103 @@
+#pragma once
+
+#include "FrameStatistics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+struct ProgramCacheStatistics
+{
+    uint64_t HitCount = 0;
+    uint64_t MissCount = 0;
+    uint64_t RejectedCount = 0;
+    double CompileMilliseconds = 0.0;
+    // misses split by what they were built from, GLSL text or offline compiled SPIR-V
+    uint64_t SpirvMissCount = 0;
+    double SpirvCompileMilliseconds = 0.0;
+    double LoadMilliseconds = 0.0;
+    double SavedMilliseconds = 0.0;
+};
+
+struct PendingShaderProgram
+{
+    std::string Label;
+    uint32_t ShaderProgram = 0;
+    uint32_t Shader = 0;
+    uint64_t Key = 0;
+    bool IsSpirv = false;
+    FrameClock::time_point StartTime;
+};
+
+// Keeps glGetProgramBinary blobs of separable single stage programs on disk, keyed on the
+// source, the stage and the driver. Blobs the driver does not accept anymore get recompiled.
+// Begin/End split compilation so a batch can be kicked off first and collected later,
+// with GL_KHR_parallel_shader_compile the driver compiles the batch on its own threads.
+class ProgramCache
+{
+public:
+    void Initialize(const std::filesystem::path& directoryPath);
+
+    std::expected<uint32_t, std::string> CreateShaderProgram(
+        std::string_view label,
+        uint32_t shaderType,
+        std::string_view shaderSource);
+
+    PendingShaderProgram BeginShaderProgram(
+        std::string_view label,
+        uint32_t shaderType,
+        std::string_view shaderSource);
+    // specializes the "main" entry point of a SPIR-V module, check IsSpirvSupported first
+    PendingShaderProgram BeginShaderProgram(
+        std::string_view label,
+        uint32_t shaderType,
+        std::span<const char> spirv);
+    bool IsShaderProgramComplete(const PendingShaderProgram& pendingShaderProgram) const;
+    std::expected<uint32_t, std::string> EndShaderProgram(PendingShaderProgram& pendingShaderProgram);
+
+    bool IsEnabled() const;
+    bool IsParallelCompileSupported() const;
+    bool IsSpirvSupported() const;
+    const ProgramCacheStatistics& GetStatistics() const;
+
+private:
+    struct FileHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t Key;
+        uint64_t DriverHash;
+        uint32_t BinaryFormat;
+        uint32_t BinarySize;
+        double CompileMilliseconds;
+    };
+
+    static constexpr uint32_t FileMagic = 0x43474F50; // "POGC"
+    static constexpr uint32_t FileVersion = 2;
+    // every source edit leaves a binary behind, the least recently used ones go beyond these
+    static constexpr size_t MaxFileCount = 512;
+    static constexpr uint64_t MaxTotalSize = 256ull * 1024 * 1024;
+
+    std::filesystem::path GetFilePath(uint64_t key) const;
+    void RemoveStaleFiles();
+    bool TryBeginFromCache(PendingShaderProgram& pendingShaderProgram);
+    void LinkShaderProgram(PendingShaderProgram& pendingShaderProgram);
+    uint32_t TryLoadProgram(
+        uint64_t key,
+        double& compileMilliseconds);
+    void StoreProgram(
+        uint64_t key,
+        uint32_t program,
+        double compileMilliseconds);
+
+    std::filesystem::path _directoryPath;
+    uint64_t _driverHash = 0;
+    bool _isEnabled = false;
+    bool _isParallelCompileSupported = false;
+    bool _isSpirvSupported = false;
+    ProgramCacheStatistics _statistics;
+};
@@ -0,0 +1,197 @@
+#include "RingBuffer.hpp"
+#include "Profiling.hpp"
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool RingBuffer::Initialize(
+    std::string_view label,
+    size_t sizePerFrame,
+    uint32_t framesInFlight)
+{
+    if (sizePerFrame == 0 || framesInFlight == 0)
+    {
+        spdlog::error("RingBuffer: {} needs a size and at least one frame in flight", label);
+        return false;
+    }
+
+    int32_t uniformBufferAlignment = 0;
+    int32_t storageBufferAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformBufferAlignment);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageBufferAlignment);
+    _uniformBufferAlignment = static_cast<size_t>(std::max(uniformBufferAlignment, 1));
+    _storageBufferAlignment = static_cast<size_t>(std::max(storageBufferAlignment, 1));
+
+    // keep every frame region aligned for whatever gets bound from its start
+    _sizePerFrame = AlignUp(sizePerFrame, std::max(_uniformBufferAlignment, _storageBufferAlignment));
+    _framesInFlight = framesInFlight;
+
+    auto totalSize = _sizePerFrame * _framesInFlight;
+    auto storageFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glCreateBuffers(1, &_buffer);
+    glObjectLabel(GL_BUFFER, _buffer, label.size(), label.data());
+    glNamedBufferStorage(_buffer, totalSize, nullptr, storageFlags);
+
+    _mappedData = static_cast<std::byte*>(glMapNamedBufferRange(_buffer, 0, totalSize, storageFlags));
+    if (_mappedData == nullptr)
+    {
+        spdlog::error("RingBuffer: Unable to map {}", label);
+        Destroy();
+        return false;
+    }
+
+    _frameFences.assign(_framesInFlight, nullptr);
+    _currentFrame = 0;
+    _currentOffset = 0;
+    _stallCount = 0;
+
+    return true;
+}
+
+void RingBuffer::Destroy()
+{
+    for (auto& frameFence : _frameFences)
+    {
+        if (frameFence != nullptr)
+        {
+            glDeleteSync(frameFence);
+            frameFence = nullptr;
+        }
+    }
+
+    if (_buffer != 0)
+    {
+        if (_mappedData != nullptr)
+        {
+            glUnmapNamedBuffer(_buffer);
+        }
+
+        glDeleteBuffers(1, &_buffer);
+    }
+
+    _buffer = 0;
+    _mappedData = nullptr;
+    _frameFences.clear();
+}
+
+void RingBuffer::BeginFrame()
+{
+    ZoneScopedN("RingBuffer::BeginFrame");
+
+    _currentFrame = (_currentFrame + 1) % _framesInFlight;
+    _currentOffset = 0;
+    _isFrameActive = true;
+
+    auto& frameFence = _frameFences[_currentFrame];
+    if (frameFence == nullptr)
+    {
+        return;
+    }
+
+    auto waitResult = glClientWaitSync(frameFence, 0, 0);
+    if (waitResult == GL_TIMEOUT_EXPIRED)
+    {
+        // the GPU is still reading this region from framesInFlight frames ago
+        _stallCount++;
+        do
+        {
+            waitResult = glClientWaitSync(frameFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+        } while (waitResult == GL_TIMEOUT_EXPIRED);
+    }
+
+    if (waitResult == GL_WAIT_FAILED)
+    {
+        spdlog::error("RingBuffer: Waiting for frame {} failed", _currentFrame);
+    }
+
+    glDeleteSync(frameFence);
+    frameFence = nullptr;
+}
+
+void RingBuffer::EndFrame()
+{
+    if (!_isFrameActive)
+    {
+        return;
+    }
+
+    auto& frameFence = _frameFences[_currentFrame];
+    if (frameFence != nullptr)
+    {
+        glDeleteSync(frameFence);
+    }
+
+    frameFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _isFrameActive = false;
+}
+
+std::optional<RingBufferAllocation> RingBuffer::Allocate(size_t size, size_t alignment)
+{
+    auto offset = AlignUp(_currentOffset, std::max<size_t>(alignment, 1));
+    if (_mappedData == nullptr || offset + size > _sizePerFrame)
+    {
+        return std::nullopt;
+    }
+
+    _currentOffset = offset + size;
+
+    auto bufferOffset = static_cast<size_t>(_currentFrame) * _sizePerFrame + offset;
+    return RingBufferAllocation
+    {
+        .Buffer = _buffer,
+        .Offset = bufferOffset,
+        .Size = size,
+        .Data = _mappedData + bufferOffset
+    };
+}
+
+std::optional<RingBufferAllocation> RingBuffer::AllocateVertices(size_t size, size_t vertexStride)
+{
+    // align the absolute offset to the stride, so Offset / vertexStride works as a base vertex
+    auto frameStart = static_cast<size_t>(_currentFrame) * _sizePerFrame;
+    _currentOffset = AlignUp(frameStart + _currentOffset, std::max<size_t>(vertexStride, 1)) - frameStart;
+    return Allocate(size, 1);
+}
+
+std::optional<RingBufferAllocation> RingBuffer::AllocateIndices(size_t size)
+{
+    return Allocate(size, sizeof(uint32_t));
+}
+
+std::optional<RingBufferAllocation> RingBuffer::AllocateUniforms(size_t size)
+{
+    return Allocate(size, _uniformBufferAlignment);
+}
+
+std::optional<RingBufferAllocation> RingBuffer::AllocateStorage(size_t size)
+{
+    return Allocate(size, _storageBufferAlignment);
+}
+
+uint32_t RingBuffer::GetBuffer() const
+{
+    return _buffer;
+}
+
+size_t RingBuffer::GetSizePerFrame() const
+{
+    return _sizePerFrame;
+}
+
+size_t RingBuffer::GetUsedSize() const
+{
+    return _currentOffset;
+}
+
+uint64_t RingBuffer::GetStallCount() const
+{
+    return _stallCount;
+}
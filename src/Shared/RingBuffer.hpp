@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+struct __GLsync;
+
+struct RingBufferAllocation
+{
+    uint32_t Buffer = 0;
+    size_t Offset = 0;
+    size_t Size = 0;
+    std::byte* Data = nullptr;
+};
+
+// One persistently mapped buffer split into framesInFlight regions. Each frame bump-allocates
+// from its own region, and a fence per region makes sure the GPU is done reading it before
+// the CPU writes there again, so streaming data never needs glBufferSubData or orphaning.
+class RingBuffer
+{
+public:
+    bool Initialize(
+        std::string_view label,
+        size_t sizePerFrame,
+        uint32_t framesInFlight = 3);
+    void Destroy();
+
+    void BeginFrame();
+    void EndFrame();
+
+    std::optional<RingBufferAllocation> Allocate(size_t size, size_t alignment);
+    std::optional<RingBufferAllocation> AllocateVertices(size_t size, size_t vertexStride);
+    std::optional<RingBufferAllocation> AllocateIndices(size_t size);
+    std::optional<RingBufferAllocation> AllocateUniforms(size_t size);
+    std::optional<RingBufferAllocation> AllocateStorage(size_t size);
+
+    template<typename T>
+    std::optional<RingBufferAllocation> Write(std::span<const T> data, size_t alignment = alignof(T))
+    {
+        auto allocation = Allocate(data.size_bytes(), alignment);
+        if (allocation.has_value())
+        {
+            std::memcpy(allocation->Data, data.data(), data.size_bytes());
+        }
+
+        return allocation;
+    }
+
+    uint32_t GetBuffer() const;
+    size_t GetSizePerFrame() const;
+    size_t GetUsedSize() const;
+    uint64_t GetStallCount() const;
+
+private:
+    uint32_t _buffer = 0;
+    std::byte* _mappedData = nullptr;
+    size_t _sizePerFrame = 0;
+    uint32_t _framesInFlight = 0;
+    uint32_t _currentFrame = 0;
+    size_t _currentOffset = 0;
+
+    size_t _uniformBufferAlignment = 256;
+    size_t _storageBufferAlignment = 256;
+
+    std::vector<__GLsync*> _frameFences;
+    uint64_t _stallCount = 0;
+    bool _isFrameActive = false;
+};
@@ -0,0 +1,278 @@
+#include "ShaderPreprocessor.hpp"
+#include "FileWatcher.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <sstream>
+
+static constexpr uint32_t MaxIncludeDepth = 32;
+
+static std::string_view TrimLeft(std::string_view text)
+{
+    auto first = text.find_first_not_of(" \t");
+    return first == std::string_view::npos ? std::string_view() : text.substr(first);
+}
+
+static bool StartsWithDirective(std::string_view line, std::string_view directive)
+{
+    line = TrimLeft(line);
+    if (line.empty() || line.front() != '#')
+    {
+        return false;
+    }
+
+    return TrimLeft(line.substr(1)).starts_with(directive);
+}
+
+std::expected<PreprocessedShader, std::string> ShaderPreprocessor::Preprocess(
+    const std::filesystem::path& filePath,
+    std::span<const std::string> defines)
+{
+    auto rootKey = FileWatcher::GetKey(filePath);
+
+    std::string defineBlock;
+    for (auto& define : defines)
+    {
+        // NAME or NAME=VALUE
+        auto separator = define.find('=');
+        defineBlock += separator == std::string::npos
+            ? std::format("#define {}\n", define)
+            : std::format("#define {} {}\n", define.substr(0, separator), define.substr(separator + 1));
+    }
+
+    auto expansionKey = HashString(defineBlock, HashString(rootKey));
+    if (auto expansion = _expansions.find(expansionKey); expansion != _expansions.end())
+    {
+        return expansion->second;
+    }
+
+    PreprocessedShader preprocessedShader;
+    auto expandResult = Expand(rootKey, preprocessedShader, defineBlock, 0);
+    if (!expandResult.has_value())
+    {
+        return std::unexpected(expandResult.error());
+    }
+
+    preprocessedShader.SourceHash = HashString(preprocessedShader.Source);
+    for (auto& fileKey : preprocessedShader.Files)
+    {
+        _dependents[fileKey].insert(rootKey);
+    }
+
+    _expansions[expansionKey] = preprocessedShader;
+    return preprocessedShader;
+}
+
+std::vector<std::string> ShaderPreprocessor::Invalidate(const std::filesystem::path& filePath)
+{
+    auto fileKey = FileWatcher::GetKey(filePath);
+    _sourceFiles.erase(fileKey);
+    _changedFiles.insert(fileKey);
+
+    auto dependents = GetDependents(filePath);
+
+    // expansions only know their root, so drop every one whose file list contains the changed file
+    std::erase_if(_expansions, [&](const auto& expansion)
+    {
+        auto& files = expansion.second.Files;
+        return std::find(files.begin(), files.end(), fileKey) != files.end();
+    });
+
+    return dependents;
+}
+
+std::vector<std::string> ShaderPreprocessor::GetDependents(const std::filesystem::path& filePath) const
+{
+    auto dependents = _dependents.find(FileWatcher::GetKey(filePath));
+    if (dependents == _dependents.end())
+    {
+        return {};
+    }
+
+    std::vector<std::string> rootFiles(dependents->second.begin(), dependents->second.end());
+    std::sort(rootFiles.begin(), rootFiles.end());
+    return rootFiles;
+}
+
+void ShaderPreprocessor::SetAssetPack(const AssetPack* assetPack)
+{
+    _assetPack = assetPack;
+}
+
+bool ShaderPreprocessor::IsChanged(const std::filesystem::path& filePath) const
+{
+    return _changedFiles.contains(FileWatcher::GetKey(filePath));
+}
+
+void ShaderPreprocessor::SetSourceDirectory(
+    const std::filesystem::path& binaryDirectory,
+    const std::filesystem::path& sourceDirectory)
+{
+    _binaryDirectory = FileWatcher::GetKey(binaryDirectory);
+    _sourceDirectory = FileWatcher::GetKey(sourceDirectory);
+}
+
+std::string ShaderPreprocessor::GetSourceFilePath(const std::filesystem::path& filePath) const
+{
+    auto fileKey = FileWatcher::GetKey(filePath);
+    if (_binaryDirectory.empty())
+    {
+        return fileKey;
+    }
+
+    auto relativePath = std::filesystem::path(fileKey).lexically_relative(_binaryDirectory);
+    if (relativePath.empty() || *relativePath.begin() == "..")
+    {
+        return fileKey;
+    }
+
+    std::error_code errorCode;
+    auto sourceFilePath = (_sourceDirectory / relativePath).lexically_normal();
+    return std::filesystem::is_regular_file(sourceFilePath, errorCode)
+        ? sourceFilePath.string()
+        : fileKey;
+}
+
+std::expected<const ShaderPreprocessor::SourceFile*, std::string> ShaderPreprocessor::GetSourceFile(const std::string& fileKey)
+{
+    if (auto sourceFile = _sourceFiles.find(fileKey); sourceFile != _sourceFiles.end())
+    {
+        return &sourceFile->second;
+    }
+
+    auto packEntry = _assetPack != nullptr && !_changedFiles.contains(fileKey)
+        ? _assetPack->Find(fileKey)
+        : nullptr;
+    if (packEntry != nullptr)
+    {
+        std::vector<std::byte> scratch;
+        auto packedContent = _assetPack->Read(*packEntry, scratch);
+        if (!packedContent.has_value())
+        {
+            return std::unexpected(packedContent.error());
+        }
+
+        SourceFile sourceFile;
+        sourceFile.Content.assign(reinterpret_cast<const char*>(packedContent->data()), packedContent->size());
+        sourceFile.ContentHash = HashString(sourceFile.Content);
+        return &(_sourceFiles[fileKey] = std::move(sourceFile));
+    }
+
+    // changed files and ones only added to the source tree since the last build come from there
+    auto diskFilePath = _changedFiles.contains(fileKey) || !std::filesystem::exists(fileKey)
+        ? GetSourceFilePath(fileKey)
+        : fileKey;
+    std::ifstream file(diskFilePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return std::unexpected(std::format("Io: Unable to read from file {}", diskFilePath));
+    }
+
+    std::stringstream content;
+    content << file.rdbuf();
+
+    SourceFile sourceFile;
+    sourceFile.Content = content.str();
+    sourceFile.ContentHash = HashString(sourceFile.Content);
+    return &(_sourceFiles[fileKey] = std::move(sourceFile));
+}
+
+std::expected<void, std::string> ShaderPreprocessor::Expand(
+    const std::string& fileKey,
+    PreprocessedShader& preprocessedShader,
+    std::string_view defineBlock,
+    uint32_t depth)
+{
+    if (depth > MaxIncludeDepth)
+    {
+        return std::unexpected(std::format("Shader: Includes nest deeper than {} levels at {}", MaxIncludeDepth, fileKey));
+    }
+
+    auto sourceFile = GetSourceFile(fileKey);
+    if (!sourceFile.has_value())
+    {
+        return std::unexpected(sourceFile.error());
+    }
+
+    auto fileIndex = static_cast<uint32_t>(preprocessedShader.Files.size());
+    preprocessedShader.Files.push_back(fileKey);
+
+    auto& source = preprocessedShader.Source;
+    if (depth > 0)
+    {
+        source += std::format("#line 1 {}\n", fileIndex);
+    }
+
+    auto hasVersion = false;
+    std::string_view content = sourceFile.value()->Content;
+    uint32_t lineNumber = 0;
+    while (!content.empty())
+    {
+        auto lineEnd = content.find('\n');
+        auto line = content.substr(0, lineEnd);
+        content = lineEnd == std::string_view::npos ? std::string_view() : content.substr(lineEnd + 1);
+        lineNumber++;
+
+        if (StartsWithDirective(line, "version"))
+        {
+            if (depth == 0 && !hasVersion)
+            {
+                hasVersion = true;
+                source += line;
+                source += '\n';
+                source += defineBlock;
+                source += std::format("#line {} {}\n", lineNumber + 1, fileIndex);
+            }
+            else
+            {
+                source += '\n';
+            }
+
+            continue;
+        }
+
+        // drivers do not know the extension, glslangValidator needs it, so it stays in the files
+        if (StartsWithDirective(line, "extension") && line.find("GL_GOOGLE_include_directive") != std::string_view::npos)
+        {
+            source += '\n';
+            continue;
+        }
+
+        if (!StartsWithDirective(line, "include"))
+        {
+            source += line;
+            source += '\n';
+            continue;
+        }
+
+        auto pathStart = line.find('"');
+        auto pathEnd = pathStart == std::string_view::npos ? std::string_view::npos : line.find('"', pathStart + 1);
+        if (pathEnd == std::string_view::npos)
+        {
+            return std::unexpected(std::format("Shader: Malformed #include in {}({})", fileKey, lineNumber));
+        }
+
+        auto includePath = std::filesystem::path(fileKey).parent_path() / line.substr(pathStart + 1, pathEnd - pathStart - 1);
+        auto includeKey = FileWatcher::GetKey(includePath);
+        auto& files = preprocessedShader.Files;
+        if (std::find(files.begin(), files.end(), includeKey) == files.end())
+        {
+            auto expandResult = Expand(includeKey, preprocessedShader, defineBlock, depth + 1);
+            if (!expandResult.has_value())
+            {
+                return std::unexpected(std::format("{}\n  included from {}({})", expandResult.error(), fileKey, lineNumber));
+            }
+        }
+
+        source += std::format("#line {} {}\n", lineNumber + 1, fileIndex);
+    }
+
+    if (depth == 0 && !hasVersion && !defineBlock.empty())
+    {
+        source.insert(0, std::format("{}#line 1 0\n", defineBlock));
+    }
+
+    return {};
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "AssetPack.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct PreprocessedShader
+{
+    std::string Source;
+    uint64_t SourceHash = 0;
+    // file keys, the root file first, the index of each one is the source string number in #line
+    std::vector<std::string> Files;
+};
+
+// Expands #include "file" (GL_GOOGLE_include_directive style, resolved relative to the including file)
+// and injects #define permutations after #version. Every file is included once. Expansions are
+// memoized until one of their files gets invalidated, and included files know which roots use them.
+class ShaderPreprocessor
+{
+public:
+    std::expected<PreprocessedShader, std::string> Preprocess(
+        const std::filesystem::path& filePath,
+        std::span<const std::string> defines = {});
+
+    // drops the cached content of a changed file and every expansion using it, returns the affected root files
+    std::vector<std::string> Invalidate(const std::filesystem::path& filePath);
+
+    std::vector<std::string> GetDependents(const std::filesystem::path& filePath) const;
+
+    // files are read from the pack until they change on disk
+    void SetAssetPack(const AssetPack* assetPack);
+    // whether the file changed on disk since startup, anything built from the pack copy is out of date
+    bool IsChanged(const std::filesystem::path& filePath) const;
+
+    // files under binaryDirectory are copies of the ones under sourceDirectory, once one of them
+    // changed it is read from the source tree, which is where edits happen
+    void SetSourceDirectory(
+        const std::filesystem::path& binaryDirectory,
+        const std::filesystem::path& sourceDirectory);
+    // the source tree file a copy was made from, or the file itself when it is no copy
+    std::string GetSourceFilePath(const std::filesystem::path& filePath) const;
+
+private:
+    struct SourceFile
+    {
+        std::string Content;
+        uint64_t ContentHash = 0;
+    };
+
+    std::expected<const SourceFile*, std::string> GetSourceFile(const std::string& fileKey);
+    std::expected<void, std::string> Expand(
+        const std::string& fileKey,
+        PreprocessedShader& preprocessedShader,
+        std::string_view defineBlock,
+        uint32_t depth);
+
+    const AssetPack* _assetPack = nullptr;
+    std::filesystem::path _binaryDirectory;
+    std::filesystem::path _sourceDirectory;
+    std::unordered_set<std::string> _changedFiles;
+    std::unordered_map<std::string, SourceFile> _sourceFiles;
+    std::unordered_map<uint64_t, PreprocessedShader> _expansions;
+    // included file -> root files which include it, directly or not
+    std::unordered_map<std::string, std::unordered_set<std::string>> _dependents;
+};
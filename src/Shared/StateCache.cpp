@@ -0,0 +1,282 @@
+#include "StateCache.hpp"
+
+#include <glad/glad.h>
+
+void StateCache::Invalidate()
+{
+    _vertexArray = Unknown;
+    _programPipeline = Unknown;
+    _program = Unknown;
+    _drawFramebuffer = Unknown;
+    _readFramebuffer = Unknown;
+    _buffers.clear();
+    _indexedBuffers.clear();
+    _textures.fill(Unknown);
+    _samplers.fill(Unknown);
+
+    _isViewportKnown = false;
+    _capabilities.clear();
+    _cullFace = Unknown;
+    _frontFace = Unknown;
+    _depthFunc = Unknown;
+    _depthMask = Unknown;
+    _blendSourceFactor = Unknown;
+    _blendDestinationFactor = Unknown;
+    _isClearColorKnown = false;
+    _isClearDepthKnown = false;
+}
+
+void StateCache::ResetFrameCounters()
+{
+    _frameCounters = {};
+}
+
+const StateCacheCounters& StateCache::GetFrameCounters() const
+{
+    return _frameCounters;
+}
+
+const StateCacheCounters& StateCache::GetTotalCounters() const
+{
+    return _totalCounters;
+}
+
+void StateCache::BindVertexArray(uint32_t vertexArray)
+{
+    if (ShouldIssue(_vertexArray == vertexArray))
+    {
+        glBindVertexArray(vertexArray);
+        _vertexArray = vertexArray;
+    }
+}
+
+void StateCache::BindProgramPipeline(uint32_t programPipeline)
+{
+    // a bound program overrides the pipeline, so only skip when neither is in the way
+    if (ShouldIssue(_programPipeline == programPipeline && _program == 0))
+    {
+        if (_program != 0)
+        {
+            glUseProgram(0);
+            _program = 0;
+        }
+
+        glBindProgramPipeline(programPipeline);
+        _programPipeline = programPipeline;
+    }
+}
+
+void StateCache::UseProgram(uint32_t program)
+{
+    if (ShouldIssue(_program == program))
+    {
+        glUseProgram(program);
+        _program = program;
+    }
+}
+
+void StateCache::BindBuffer(uint32_t target, uint32_t buffer)
+{
+    auto boundBuffer = _buffers.find(target);
+    if (ShouldIssue(boundBuffer != _buffers.end() && boundBuffer->second == buffer))
+    {
+        glBindBuffer(target, buffer);
+        _buffers[target] = buffer;
+    }
+}
+
+void StateCache::BindBufferBase(uint32_t target, uint32_t index, uint32_t buffer)
+{
+    auto& binding = _indexedBuffers[MakeIndexedKey(target, index)];
+    if (ShouldIssue(binding.Buffer == buffer && binding.Offset == 0 && binding.Size == 0))
+    {
+        glBindBufferBase(target, index, buffer);
+        binding = { .Buffer = buffer, .Offset = 0, .Size = 0 };
+
+        // binding a base or range also changes the generic binding point
+        _buffers[target] = buffer;
+    }
+}
+
+void StateCache::BindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, size_t offset, size_t size)
+{
+    auto& binding = _indexedBuffers[MakeIndexedKey(target, index)];
+    if (ShouldIssue(binding.Buffer == buffer && binding.Offset == offset && binding.Size == size))
+    {
+        glBindBufferRange(target, index, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+        binding = { .Buffer = buffer, .Offset = offset, .Size = size };
+        _buffers[target] = buffer;
+    }
+}
+
+void StateCache::BindTextureUnit(uint32_t unit, uint32_t texture)
+{
+    if (unit >= MaxTrackedUnits)
+    {
+        _frameCounters.IssuedCalls++;
+        _totalCounters.IssuedCalls++;
+        glBindTextureUnit(unit, texture);
+        return;
+    }
+
+    if (ShouldIssue(_textures[unit] == texture))
+    {
+        glBindTextureUnit(unit, texture);
+        _textures[unit] = texture;
+    }
+}
+
+void StateCache::BindSampler(uint32_t unit, uint32_t sampler)
+{
+    if (unit >= MaxTrackedUnits)
+    {
+        _frameCounters.IssuedCalls++;
+        _totalCounters.IssuedCalls++;
+        glBindSampler(unit, sampler);
+        return;
+    }
+
+    if (ShouldIssue(_samplers[unit] == sampler))
+    {
+        glBindSampler(unit, sampler);
+        _samplers[unit] = sampler;
+    }
+}
+
+void StateCache::BindFramebuffer(uint32_t target, uint32_t framebuffer)
+{
+    auto isDrawTarget = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+    auto isReadTarget = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    auto isRedundant =
+        (!isDrawTarget || _drawFramebuffer == framebuffer) &&
+        (!isReadTarget || _readFramebuffer == framebuffer);
+    if (ShouldIssue(isRedundant))
+    {
+        glBindFramebuffer(target, framebuffer);
+        if (isDrawTarget)
+        {
+            _drawFramebuffer = framebuffer;
+        }
+
+        if (isReadTarget)
+        {
+            _readFramebuffer = framebuffer;
+        }
+    }
+}
+
+void StateCache::SetViewport(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    std::array<int32_t, 4> viewport = { x, y, width, height };
+    if (ShouldIssue(_isViewportKnown && _viewport == viewport))
+    {
+        glViewport(x, y, width, height);
+        _viewport = viewport;
+        _isViewportKnown = true;
+    }
+}
+
+void StateCache::SetEnabled(uint32_t capability, bool isEnabled)
+{
+    auto capabilityState = _capabilities.find(capability);
+    if (ShouldIssue(capabilityState != _capabilities.end() && capabilityState->second == isEnabled))
+    {
+        if (isEnabled)
+        {
+            glEnable(capability);
+        }
+        else
+        {
+            glDisable(capability);
+        }
+
+        _capabilities[capability] = isEnabled;
+    }
+}
+
+void StateCache::SetCullFace(uint32_t cullFace)
+{
+    if (ShouldIssue(_cullFace == cullFace))
+    {
+        glCullFace(cullFace);
+        _cullFace = cullFace;
+    }
+}
+
+void StateCache::SetFrontFace(uint32_t frontFace)
+{
+    if (ShouldIssue(_frontFace == frontFace))
+    {
+        glFrontFace(frontFace);
+        _frontFace = frontFace;
+    }
+}
+
+void StateCache::SetDepthFunc(uint32_t depthFunc)
+{
+    if (ShouldIssue(_depthFunc == depthFunc))
+    {
+        glDepthFunc(depthFunc);
+        _depthFunc = depthFunc;
+    }
+}
+
+void StateCache::SetDepthMask(bool isDepthWriteEnabled)
+{
+    auto depthMask = isDepthWriteEnabled ? GL_TRUE : GL_FALSE;
+    if (ShouldIssue(_depthMask == static_cast<uint32_t>(depthMask)))
+    {
+        glDepthMask(depthMask);
+        _depthMask = depthMask;
+    }
+}
+
+void StateCache::SetBlendFunc(uint32_t sourceFactor, uint32_t destinationFactor)
+{
+    if (ShouldIssue(_blendSourceFactor == sourceFactor && _blendDestinationFactor == destinationFactor))
+    {
+        glBlendFunc(sourceFactor, destinationFactor);
+        _blendSourceFactor = sourceFactor;
+        _blendDestinationFactor = destinationFactor;
+    }
+}
+
+void StateCache::SetClearColor(float red, float green, float blue, float alpha)
+{
+    std::array<float, 4> clearColor = { red, green, blue, alpha };
+    if (ShouldIssue(_isClearColorKnown && _clearColor == clearColor))
+    {
+        glClearColor(red, green, blue, alpha);
+        _clearColor = clearColor;
+        _isClearColorKnown = true;
+    }
+}
+
+void StateCache::SetClearDepth(float depth)
+{
+    if (ShouldIssue(_isClearDepthKnown && _clearDepth == depth))
+    {
+        glClearDepthf(depth);
+        _clearDepth = depth;
+        _isClearDepthKnown = true;
+    }
+}
+
+bool StateCache::ShouldIssue(bool isRedundant)
+{
+    if (isRedundant)
+    {
+        _frameCounters.ElidedCalls++;
+        _totalCounters.ElidedCalls++;
+        return false;
+    }
+
+    _frameCounters.IssuedCalls++;
+    _totalCounters.IssuedCalls++;
+    return true;
+}
+
+uint64_t StateCache::MakeIndexedKey(uint32_t target, uint32_t index)
+{
+    return (static_cast<uint64_t>(target) << 32) | index;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+struct StateCacheCounters
+{
+    uint64_t IssuedCalls = 0;
+    uint64_t ElidedCalls = 0;
+};
+
+// Remembers the GL state set through it and skips calls which would not change anything.
+// Code binding state behind its back has to call Invalidate() afterwards.
+class StateCache
+{
+public:
+    void Invalidate();
+
+    void ResetFrameCounters();
+    const StateCacheCounters& GetFrameCounters() const;
+    const StateCacheCounters& GetTotalCounters() const;
+
+    void BindVertexArray(uint32_t vertexArray);
+    void BindProgramPipeline(uint32_t programPipeline);
+    void UseProgram(uint32_t program);
+    void BindBuffer(uint32_t target, uint32_t buffer);
+    void BindBufferBase(uint32_t target, uint32_t index, uint32_t buffer);
+    void BindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, size_t offset, size_t size);
+    void BindTextureUnit(uint32_t unit, uint32_t texture);
+    void BindSampler(uint32_t unit, uint32_t sampler);
+    void BindFramebuffer(uint32_t target, uint32_t framebuffer);
+
+    void SetViewport(int32_t x, int32_t y, int32_t width, int32_t height);
+    void SetEnabled(uint32_t capability, bool isEnabled);
+    void SetCullFace(uint32_t cullFace);
+    void SetFrontFace(uint32_t frontFace);
+    void SetDepthFunc(uint32_t depthFunc);
+    void SetDepthMask(bool isDepthWriteEnabled);
+    void SetBlendFunc(uint32_t sourceFactor, uint32_t destinationFactor);
+    void SetClearColor(float red, float green, float blue, float alpha);
+    void SetClearDepth(float depth);
+
+private:
+    static constexpr uint32_t Unknown = UINT32_MAX;
+    static constexpr uint32_t MaxTrackedUnits = 32;
+
+    struct IndexedBufferBinding
+    {
+        uint32_t Buffer = Unknown;
+        size_t Offset = 0;
+        size_t Size = 0;
+    };
+
+    bool ShouldIssue(bool isRedundant);
+
+    static uint64_t MakeIndexedKey(uint32_t target, uint32_t index);
+
+    uint32_t _vertexArray = Unknown;
+    uint32_t _programPipeline = Unknown;
+    uint32_t _program = Unknown;
+    uint32_t _drawFramebuffer = Unknown;
+    uint32_t _readFramebuffer = Unknown;
+    std::unordered_map<uint32_t, uint32_t> _buffers;
+    std::unordered_map<uint64_t, IndexedBufferBinding> _indexedBuffers;
+    std::array<uint32_t, MaxTrackedUnits> _textures = {};
+    std::array<uint32_t, MaxTrackedUnits> _samplers = {};
+
+    std::array<int32_t, 4> _viewport = {};
+    bool _isViewportKnown = false;
+    std::unordered_map<uint32_t, bool> _capabilities;
+    uint32_t _cullFace = Unknown;
+    uint32_t _frontFace = Unknown;
+    uint32_t _depthFunc = Unknown;
+    uint32_t _depthMask = Unknown;
+    uint32_t _blendSourceFactor = Unknown;
+    uint32_t _blendDestinationFactor = Unknown;
+    std::array<float, 4> _clearColor = {};
+    bool _isClearColorKnown = false;
+    float _clearDepth = 0.0f;
+    bool _isClearDepthKnown = false;
+
+    StateCacheCounters _frameCounters;
+    StateCacheCounters _totalCounters;
+};
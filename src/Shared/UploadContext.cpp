@@ -0,0 +1,167 @@
+#include "UploadContext.hpp"
+#include "Profiling.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <spdlog/spdlog.h>
+
+#include <memory>
+
+bool UploadContext::Initialize(GLFWwindow* uploadWindow)
+{
+    if (uploadWindow == nullptr)
+    {
+        return false;
+    }
+
+    _uploadWindow = uploadWindow;
+    _isStopping = false;
+    _uploadThread = std::thread(&UploadContext::ThreadMain, this);
+
+    spdlog::info("App: Uploading on a shared context thread");
+    return true;
+}
+
+void UploadContext::Destroy()
+{
+    if (_uploadWindow == nullptr)
+    {
+        return;
+    }
+
+    // the thread works off what is queued before it stops, so nothing submitted gets lost
+    {
+        std::lock_guard lock(_taskMutex);
+        _isStopping = true;
+    }
+
+    _taskCondition.notify_one();
+    _uploadThread.join();
+
+    for (auto& fencedTask : _fencedTasks)
+    {
+        glClientWaitSync(fencedTask.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+        glDeleteSync(fencedTask.Fence);
+        fencedTask.OnReady();
+    }
+
+    _fencedTasks.clear();
+    _pendingCount = 0;
+
+    glfwDestroyWindow(_uploadWindow);
+    _uploadWindow = nullptr;
+}
+
+bool UploadContext::IsEnabled() const
+{
+    return _uploadWindow != nullptr;
+}
+
+void UploadContext::Submit(
+    std::function<void()> upload,
+    std::function<void()> onReady)
+{
+    {
+        std::lock_guard lock(_taskMutex);
+        _uploadTasks.push_back({ .Upload = std::move(upload), .OnReady = std::move(onReady) });
+    }
+
+    _pendingCount++;
+    _taskCondition.notify_one();
+}
+
+void UploadContext::SubmitBuffer(
+    std::string label,
+    std::vector<std::byte> data,
+    std::function<void(uint32_t)> onReady)
+{
+    auto bufferData = std::make_shared<std::vector<std::byte>>(std::move(data));
+    auto uploadedBuffer = std::make_shared<uint32_t>(0);
+    Submit(
+        [bufferData, uploadedBuffer, label = std::move(label)]()
+        {
+            glCreateBuffers(1, uploadedBuffer.get());
+            glObjectLabel(GL_BUFFER, *uploadedBuffer, static_cast<int32_t>(label.size()), label.data());
+            glNamedBufferStorage(*uploadedBuffer, bufferData->size(), bufferData->data(), 0);
+            bufferData->clear();
+            bufferData->shrink_to_fit();
+        },
+        [uploadedBuffer, onReady = std::move(onReady)]()
+        {
+            onReady(*uploadedBuffer);
+        });
+}
+
+uint32_t UploadContext::Update()
+{
+    std::deque<FencedTask> readyTasks;
+    {
+        std::lock_guard lock(_taskMutex);
+        while (!_fencedTasks.empty())
+        {
+            // fences signal in submission order, the first unsignaled one ends the search
+            auto waitResult = glClientWaitSync(_fencedTasks.front().Fence, 0, 0);
+            if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+            {
+                break;
+            }
+
+            readyTasks.push_back(std::move(_fencedTasks.front()));
+            _fencedTasks.pop_front();
+        }
+    }
+
+    for (auto& readyTask : readyTasks)
+    {
+        glDeleteSync(readyTask.Fence);
+        readyTask.OnReady();
+    }
+
+    _pendingCount -= static_cast<uint32_t>(readyTasks.size());
+    return static_cast<uint32_t>(readyTasks.size());
+}
+
+uint32_t UploadContext::GetPendingCount() const
+{
+    return _pendingCount;
+}
+
+void UploadContext::ThreadMain()
+{
+    tracy::SetThreadName("Upload");
+    glfwMakeContextCurrent(_uploadWindow);
+
+    while (true)
+    {
+        UploadTask uploadTask;
+        {
+            std::unique_lock lock(_taskMutex);
+            _taskCondition.wait(lock, [this]()
+            {
+                return _isStopping || !_uploadTasks.empty();
+            });
+
+            if (_uploadTasks.empty())
+            {
+                break;
+            }
+
+            uploadTask = std::move(_uploadTasks.front());
+            _uploadTasks.pop_front();
+        }
+
+        {
+            ZoneScopedN("UploadContext::Upload");
+            uploadTask.Upload();
+        }
+
+        // without the flush the fence might never reach the gpu and the render thread would wait forever
+        auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::lock_guard lock(_taskMutex);
+        _fencedTasks.push_back({ .Fence = fence, .OnReady = std::move(uploadTask.OnReady) });
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
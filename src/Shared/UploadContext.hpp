@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct GLFWwindow;
+struct __GLsync;
+
+// Runs uploads on a dedicated thread with its own context sharing objects with the render context.
+// Each upload is fenced, OnReady runs on the render thread in Update once the fence signaled.
+// Only share buffers and textures this way, container objects like VAOs and FBOs are per context.
+class UploadContext
+{
+public:
+    // takes ownership of the hidden window, which has to be created on the main thread
+    bool Initialize(GLFWwindow* uploadWindow);
+    void Destroy();
+
+    bool IsEnabled() const;
+
+    void Submit(
+        std::function<void()> upload,
+        std::function<void()> onReady);
+    // creates an immutable buffer holding data on the upload thread, onReady gets its name once it is usable
+    void SubmitBuffer(
+        std::string label,
+        std::vector<std::byte> data,
+        std::function<void(uint32_t)> onReady);
+
+    // render thread, returns the number of uploads which became ready
+    uint32_t Update();
+    uint32_t GetPendingCount() const;
+
+private:
+    struct UploadTask
+    {
+        std::function<void()> Upload;
+        std::function<void()> OnReady;
+    };
+
+    struct FencedTask
+    {
+        __GLsync* Fence = nullptr;
+        std::function<void()> OnReady;
+    };
+
+    void ThreadMain();
+
+    GLFWwindow* _uploadWindow = nullptr;
+    std::thread _uploadThread;
+
+    std::mutex _taskMutex;
+    std::condition_variable _taskCondition;
+    std::deque<UploadTask> _uploadTasks;
+    std::deque<FencedTask> _fencedTasks;
+    bool _isStopping = false;
+
+    uint32_t _pendingCount = 0;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// Packed vertex attributes, written by VertexQuantization and read by the GPU through the
+// matching VertexComponentTraits in VertexLayout.hpp.
+// Positions are padded to 8 bytes so the next attribute stays 4 byte aligned.
+
+// decodes to [-1, 1], the mesh's PositionQuantization maps that back onto its bounds
+struct PackedPositionSnorm16
+{
+    int16_t X;
+    int16_t Y;
+    int16_t Z;
+    int16_t Padding;
+};
+
+// unit normal folded onto the octahedron, decode with
+//   vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y)); if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy); normalize(n)
+struct PackedNormalOctahedral
+{
+    int16_t X;
+    int16_t Y;
+};
+
+// [0, 1] only, repeating uvs do not fit
+struct PackedUvUnorm16
+{
+    uint16_t U;
+    uint16_t V;
+};
+
+struct PackedColorUnorm8
+{
+    uint8_t R;
+    uint8_t G;
+    uint8_t B;
+    uint8_t A;
+};
+
+static_assert(sizeof(PackedPositionSnorm16) == 8);
+static_assert(sizeof(PackedNormalOctahedral) == 4);
+static_assert(sizeof(PackedUvUnorm16) == 4);
+static_assert(sizeof(PackedColorUnorm8) == 4);
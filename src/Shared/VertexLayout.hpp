@@ -0,0 +1,279 @@
+#pragma once
+
+#include "InputLayout.hpp"
+#include "VertexComponents.hpp"
+#include "VertexPositionColor.hpp"
+#include "VertexPositionColorQuantized.hpp"
+#include "VertexPositionNormalUv.hpp"
+#include "VertexPositionNormalUvQuantized.hpp"
+#include "VertexPositionUv.hpp"
+#include "VertexPositionUvQuantized.hpp"
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// what glVertexArrayAttribFormat needs to read a vertex member of type TComponent
+template<typename TComponent>
+struct VertexComponentTraits;
+
+template<>
+struct VertexComponentTraits<glm::vec2>
+{
+    static constexpr uint32_t ComponentCount = 2;
+    static constexpr uint32_t ComponentType = GL_FLOAT;
+    static constexpr bool IsNormalized = false;
+    static constexpr bool IsInteger = false;
+};
+
+template<>
+struct VertexComponentTraits<glm::vec3>
+{
+    static constexpr uint32_t ComponentCount = 3;
+    static constexpr uint32_t ComponentType = GL_FLOAT;
+    static constexpr bool IsNormalized = false;
+    static constexpr bool IsInteger = false;
+};
+
+template<>
+struct VertexComponentTraits<glm::vec4>
+{
+    static constexpr uint32_t ComponentCount = 4;
+    static constexpr uint32_t ComponentType = GL_FLOAT;
+    static constexpr bool IsNormalized = false;
+    static constexpr bool IsInteger = false;
+};
+
+template<>
+struct VertexComponentTraits<uint32_t>
+{
+    static constexpr uint32_t ComponentCount = 1;
+    static constexpr uint32_t ComponentType = GL_UNSIGNED_INT;
+    static constexpr bool IsNormalized = false;
+    static constexpr bool IsInteger = true;
+};
+
+template<>
+struct VertexComponentTraits<PackedPositionSnorm16>
+{
+    static constexpr uint32_t ComponentCount = 3;
+    static constexpr uint32_t ComponentType = GL_SHORT;
+    static constexpr bool IsNormalized = true;
+    static constexpr bool IsInteger = false;
+};
+
+template<>
+struct VertexComponentTraits<PackedNormalOctahedral>
+{
+    static constexpr uint32_t ComponentCount = 2;
+    static constexpr uint32_t ComponentType = GL_SHORT;
+    static constexpr bool IsNormalized = true;
+    static constexpr bool IsInteger = false;
+};
+
+template<>
+struct VertexComponentTraits<PackedUvUnorm16>
+{
+    static constexpr uint32_t ComponentCount = 2;
+    static constexpr uint32_t ComponentType = GL_UNSIGNED_SHORT;
+    static constexpr bool IsNormalized = true;
+    static constexpr bool IsInteger = false;
+};
+
+template<>
+struct VertexComponentTraits<PackedColorUnorm8>
+{
+    static constexpr uint32_t ComponentCount = 4;
+    static constexpr uint32_t ComponentType = GL_UNSIGNED_BYTE;
+    static constexpr bool IsNormalized = true;
+    static constexpr bool IsInteger = false;
+};
+
+template<typename TComponent>
+constexpr InputLayoutElement MakeInputLayoutElement(
+    uint32_t attributeIndex,
+    uint32_t offset,
+    uint32_t bindingIndex = 0,
+    uint32_t divisor = 0)
+{
+    using Traits = VertexComponentTraits<TComponent>;
+    return
+    {
+        .AttributeIndex = attributeIndex,
+        .ComponentCount = Traits::ComponentCount,
+        .ComponentType = Traits::ComponentType,
+        .IsNormalized = Traits::IsNormalized,
+        .IsInteger = Traits::IsInteger,
+        .Offset = offset,
+        .BindingIndex = bindingIndex,
+        .Divisor = divisor
+    };
+}
+
+// Vertex structs are reflected like an aggregate initializer sees them, one attribute per member in
+// declaration order, offsets laid out the way the compiler lays out a standard layout struct.
+namespace VertexLayoutDetail
+{
+    // converts to whatever member it initializes, only ever used unevaluated
+    struct AnyMember
+    {
+        template<typename TMember>
+        operator TMember() const;
+    };
+
+    template<typename TVertex>
+    TVertex& DeclareVertex();
+
+    template<typename TVertex, typename... TMembers>
+    constexpr uint32_t CountMembers()
+    {
+        if constexpr (requires { TVertex{ TMembers{}..., AnyMember{} }; })
+        {
+            return CountMembers<TVertex, TMembers..., AnyMember>();
+        }
+        else
+        {
+            return sizeof...(TMembers);
+        }
+    }
+
+    template<typename... TMembers>
+    using MemberTypes = std::tuple<std::remove_cvref_t<TMembers>...>;
+
+    // only named inside decltype, the structured bindings never bind to anything real
+    template<typename TVertex>
+    constexpr auto GetMemberTypes()
+    {
+        constexpr auto memberCount = CountMembers<TVertex>();
+        static_assert(memberCount >= 1 && memberCount <= 6, "VertexTraits handles vertices of 1 to 6 members");
+
+        auto& vertex = DeclareVertex<TVertex>();
+        if constexpr (memberCount == 1)
+        {
+            auto& [m0] = vertex;
+            return std::type_identity<MemberTypes<decltype(m0)>>{};
+        }
+        else if constexpr (memberCount == 2)
+        {
+            auto& [m0, m1] = vertex;
+            return std::type_identity<MemberTypes<decltype(m0), decltype(m1)>>{};
+        }
+        else if constexpr (memberCount == 3)
+        {
+            auto& [m0, m1, m2] = vertex;
+            return std::type_identity<MemberTypes<decltype(m0), decltype(m1), decltype(m2)>>{};
+        }
+        else if constexpr (memberCount == 4)
+        {
+            auto& [m0, m1, m2, m3] = vertex;
+            return std::type_identity<MemberTypes<decltype(m0), decltype(m1), decltype(m2), decltype(m3)>>{};
+        }
+        else if constexpr (memberCount == 5)
+        {
+            auto& [m0, m1, m2, m3, m4] = vertex;
+            return std::type_identity<MemberTypes<decltype(m0), decltype(m1), decltype(m2), decltype(m3), decltype(m4)>>{};
+        }
+        else
+        {
+            auto& [m0, m1, m2, m3, m4, m5] = vertex;
+            return std::type_identity<MemberTypes<decltype(m0), decltype(m1), decltype(m2), decltype(m3), decltype(m4), decltype(m5)>>{};
+        }
+    }
+
+    template<typename TComponent>
+    concept VertexComponent = requires
+    {
+        VertexComponentTraits<TComponent>::ComponentCount;
+    };
+
+    constexpr uint32_t AlignUp(
+        uint32_t value,
+        uint32_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+template<typename TVertex>
+struct VertexTraits
+{
+    static_assert(std::is_aggregate_v<TVertex> && std::is_standard_layout_v<TVertex>, "vertices have to be plain structs");
+
+    using Members = typename decltype(VertexLayoutDetail::GetMemberTypes<TVertex>())::type;
+
+    static constexpr uint32_t AttributeCount = std::tuple_size_v<Members>;
+    static constexpr uint32_t Stride = sizeof(TVertex);
+
+    static constexpr std::array<uint32_t, AttributeCount> Offsets = []<size_t... MemberIndices>(std::index_sequence<MemberIndices...>)
+    {
+        std::array<uint32_t, AttributeCount> offsets = {};
+        uint32_t offset = 0;
+        ((offset = VertexLayoutDetail::AlignUp(offset, alignof(std::tuple_element_t<MemberIndices, Members>)),
+          offsets[MemberIndices] = offset,
+          offset += sizeof(std::tuple_element_t<MemberIndices, Members>)), ...);
+        return offsets;
+    }(std::make_index_sequence<AttributeCount>());
+
+    // members the reflection missed or a base class would leave bytes unaccounted for
+    static_assert(
+        VertexLayoutDetail::AlignUp(
+            Offsets.back() + static_cast<uint32_t>(sizeof(std::tuple_element_t<AttributeCount - 1, Members>)),
+            alignof(TVertex)) == Stride,
+        "vertex members do not add up to the vertex stride");
+
+    static_assert(
+        []<size_t... MemberIndices>(std::index_sequence<MemberIndices...>)
+        {
+            return (VertexLayoutDetail::VertexComponent<std::tuple_element_t<MemberIndices, Members>> && ...);
+        }(std::make_index_sequence<AttributeCount>()),
+        "every vertex member needs a VertexComponentTraits specialization");
+
+    // attributes are numbered from firstAttributeIndex in member order, instance data passes a divisor
+    static constexpr std::array<InputLayoutElement, AttributeCount> GetElements(
+        uint32_t firstAttributeIndex = 0,
+        uint32_t bindingIndex = 0,
+        uint32_t divisor = 0)
+    {
+        return [&]<size_t... MemberIndices>(std::index_sequence<MemberIndices...>)
+        {
+            return std::array<InputLayoutElement, AttributeCount>
+            {
+                MakeInputLayoutElement<std::tuple_element_t<MemberIndices, Members>>(
+                    firstAttributeIndex + static_cast<uint32_t>(MemberIndices),
+                    Offsets[MemberIndices],
+                    bindingIndex,
+                    divisor)...
+            };
+        }(std::make_index_sequence<AttributeCount>());
+    }
+
+    static constexpr std::array<InputLayoutElement, AttributeCount> Elements = GetElements();
+};
+
+// per vertex and per instance streams go into one layout
+template<size_t LeftCount, size_t RightCount>
+constexpr std::array<InputLayoutElement, LeftCount + RightCount> ConcatenateInputLayoutElements(
+    const std::array<InputLayoutElement, LeftCount>& left,
+    const std::array<InputLayoutElement, RightCount>& right)
+{
+    std::array<InputLayoutElement, LeftCount + RightCount> elements = {};
+    std::copy(left.begin(), left.end(), elements.begin());
+    std::copy(right.begin(), right.end(), elements.begin() + LeftCount);
+    return elements;
+}
+
+static_assert(VertexTraits<VertexPositionUv>::Stride == 20);
+static_assert(VertexTraits<VertexPositionColor>::Stride == 24);
+static_assert(VertexTraits<VertexPositionNormalUv>::Stride == 32);
+static_assert(VertexTraits<VertexPositionUvQuantized>::Stride == 12);
+static_assert(VertexTraits<VertexPositionColorQuantized>::Stride == 12);
+static_assert(VertexTraits<VertexPositionNormalUvQuantized>::Stride == 16);
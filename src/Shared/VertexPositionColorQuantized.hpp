@@ -0,0 +1,10 @@
+#pragma once
+
+#include "VertexComponents.hpp"
+
+// 12 bytes instead of VertexPositionColor's 24
+struct VertexPositionColorQuantized
+{
+    PackedPositionSnorm16 Position;
+    PackedColorUnorm8 Color;
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/vec2.hpp>
+
+struct VertexPositionNormalUv
+{
+    glm::vec3 Position;
+    glm::vec3 Normal;
+    glm::vec2 Uv;
+};
\ No newline at end of file
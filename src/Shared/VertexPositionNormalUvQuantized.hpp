@@ -0,0 +1,11 @@
+#pragma once
+
+#include "VertexComponents.hpp"
+
+// 16 bytes instead of the 32 of three float vectors
+struct VertexPositionNormalUvQuantized
+{
+    PackedPositionSnorm16 Position;
+    PackedNormalOctahedral Normal;
+    PackedUvUnorm16 Uv;
+};
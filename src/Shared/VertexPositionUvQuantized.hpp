@@ -0,0 +1,10 @@
+#pragma once
+
+#include "VertexComponents.hpp"
+
+// 12 bytes instead of VertexPositionUv's 20
+struct VertexPositionUvQuantized
+{
+    PackedPositionSnorm16 Position;
+    PackedUvUnorm16 Uv;
+};
@@ -0,0 +1,256 @@
+#include "VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VERTEX_QUANTIZATION_SSE2
+#include <emmintrin.h>
+#endif
+
+// nearbyint rounds to nearest even like cvtps2dq does, so both paths produce the same bits
+static int16_t EncodeSnorm16(float value)
+{
+    return static_cast<int16_t>(std::nearbyint(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+// value is already multiplied by 32767, the same single multiply the SSE2 path does
+static int16_t EncodeScaledSnorm16(float value)
+{
+    return static_cast<int16_t>(std::nearbyint(std::clamp(value, -32767.0f, 32767.0f)));
+}
+
+static uint16_t EncodeUnorm16(float value)
+{
+    return static_cast<uint16_t>(std::nearbyint(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+static uint8_t EncodeUnorm8(float value)
+{
+    return static_cast<uint8_t>(std::nearbyint(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+PositionQuantization ComputePositionQuantization(
+    glm::vec3 boundsMin,
+    glm::vec3 boundsMax)
+{
+    PositionQuantization positionQuantization = {};
+    for (auto axis = 0; axis < 3; axis++)
+    {
+        auto halfExtent = (boundsMax[axis] - boundsMin[axis]) * 0.5f;
+        positionQuantization.Offset[axis] = (boundsMax[axis] + boundsMin[axis]) * 0.5f;
+        positionQuantization.Scale[axis] = halfExtent > 0.0f ? halfExtent : 1.0f;
+    }
+
+    return positionQuantization;
+}
+
+void EncodePositionsSnorm16(
+    std::span<const glm::vec3> positions,
+    const PositionQuantization& positionQuantization,
+    std::span<PackedPositionSnorm16> encodedPositions)
+{
+    auto& scale = positionQuantization.Scale;
+    glm::vec3 range = { 32767.0f / scale.x, 32767.0f / scale.y, 32767.0f / scale.z };
+    size_t vertexIndex = 0;
+
+#if defined(VERTEX_QUANTIZATION_SSE2)
+    // two vertices per iteration, each load reads one float past its vertex, hence the tail
+    auto source = reinterpret_cast<const float*>(positions.data());
+    auto offset = _mm_setr_ps(positionQuantization.Offset.x, positionQuantization.Offset.y, positionQuantization.Offset.z, 0.0f);
+    auto ranges = _mm_setr_ps(range.x, range.y, range.z, 0.0f);
+    auto paddingMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    auto minimum = _mm_set1_ps(-32767.0f);
+    auto maximum = _mm_set1_ps(32767.0f);
+    for (; vertexIndex + 2 < positions.size(); vertexIndex += 2)
+    {
+        auto position0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(source + vertexIndex * 3), offset), ranges);
+        auto position1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(source + vertexIndex * 3 + 3), offset), ranges);
+        position0 = _mm_and_ps(_mm_min_ps(_mm_max_ps(position0, minimum), maximum), paddingMask);
+        position1 = _mm_and_ps(_mm_min_ps(_mm_max_ps(position1, minimum), maximum), paddingMask);
+
+        auto packed = _mm_packs_epi32(_mm_cvtps_epi32(position0), _mm_cvtps_epi32(position1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&encodedPositions[vertexIndex]), packed);
+    }
+#endif
+
+    for (; vertexIndex < positions.size(); vertexIndex++)
+    {
+        auto scaled = (positions[vertexIndex] - positionQuantization.Offset) * range;
+        encodedPositions[vertexIndex] =
+        {
+            .X = EncodeScaledSnorm16(scaled.x),
+            .Y = EncodeScaledSnorm16(scaled.y),
+            .Z = EncodeScaledSnorm16(scaled.z),
+            .Padding = 0
+        };
+    }
+}
+
+void EncodeNormalsOctahedral(
+    std::span<const glm::vec3> normals,
+    std::span<PackedNormalOctahedral> encodedNormals)
+{
+    // the folding branches per vertex, it stays scalar
+    for (size_t vertexIndex = 0; vertexIndex < normals.size(); vertexIndex++)
+    {
+        auto& normal = normals[vertexIndex];
+        auto inverseLength = 1.0f / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+        auto x = normal.x * inverseLength;
+        auto y = normal.y * inverseLength;
+        if (normal.z < 0.0f)
+        {
+            auto foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            auto foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldedX;
+            y = foldedY;
+        }
+
+        encodedNormals[vertexIndex] = { .X = EncodeSnorm16(x), .Y = EncodeSnorm16(y) };
+    }
+}
+
+void EncodeUvsUnorm16(
+    std::span<const glm::vec2> uvs,
+    std::span<PackedUvUnorm16> encodedUvs)
+{
+    size_t vertexIndex = 0;
+
+#if defined(VERTEX_QUANTIZATION_SSE2)
+    // SSE2 has no unsigned 32 to 16 bit pack, bias into signed range and flip the top bit back
+    auto source = reinterpret_cast<const float*>(uvs.data());
+    auto minimum = _mm_setzero_ps();
+    auto maximum = _mm_set1_ps(1.0f);
+    auto scale = _mm_set1_ps(65535.0f);
+    auto bias = _mm_set1_epi32(32768);
+    auto signFlip = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+    for (; vertexIndex + 4 <= uvs.size(); vertexIndex += 4)
+    {
+        auto uvs01 = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + vertexIndex * 2), minimum), maximum), scale);
+        auto uvs23 = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + vertexIndex * 2 + 4), minimum), maximum), scale);
+        auto biased01 = _mm_sub_epi32(_mm_cvtps_epi32(uvs01), bias);
+        auto biased23 = _mm_sub_epi32(_mm_cvtps_epi32(uvs23), bias);
+
+        auto packed = _mm_xor_si128(_mm_packs_epi32(biased01, biased23), signFlip);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&encodedUvs[vertexIndex]), packed);
+    }
+#endif
+
+    for (; vertexIndex < uvs.size(); vertexIndex++)
+    {
+        encodedUvs[vertexIndex] = { .U = EncodeUnorm16(uvs[vertexIndex].x), .V = EncodeUnorm16(uvs[vertexIndex].y) };
+    }
+}
+
+void EncodeColorsUnorm8(
+    std::span<const glm::vec4> colors,
+    std::span<PackedColorUnorm8> encodedColors)
+{
+    size_t vertexIndex = 0;
+
+#if defined(VERTEX_QUANTIZATION_SSE2)
+    auto source = reinterpret_cast<const float*>(colors.data());
+    auto minimum = _mm_setzero_ps();
+    auto maximum = _mm_set1_ps(1.0f);
+    auto scale = _mm_set1_ps(255.0f);
+    for (; vertexIndex + 4 <= colors.size(); vertexIndex += 4)
+    {
+        __m128i channels[4];
+        for (size_t colorIndex = 0; colorIndex < 4; colorIndex++)
+        {
+            auto color = _mm_loadu_ps(source + (vertexIndex + colorIndex) * 4);
+            channels[colorIndex] = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(color, minimum), maximum), scale));
+        }
+
+        auto packed = _mm_packus_epi16(_mm_packs_epi32(channels[0], channels[1]), _mm_packs_epi32(channels[2], channels[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&encodedColors[vertexIndex]), packed);
+    }
+#endif
+
+    for (; vertexIndex < colors.size(); vertexIndex++)
+    {
+        auto& color = colors[vertexIndex];
+        encodedColors[vertexIndex] =
+        {
+            .R = EncodeUnorm8(color.x),
+            .G = EncodeUnorm8(color.y),
+            .B = EncodeUnorm8(color.z),
+            .A = EncodeUnorm8(color.w)
+        };
+    }
+}
+
+// encodes everything once in bulk, which takes the SIMD loops, and once one element at a time,
+// which only ever takes the scalar tails
+template<typename TValue, typename TEncoded, typename TEncode>
+static bool IsEncodedLikeScalar(
+    std::span<const TValue> values,
+    TEncode encode)
+{
+    std::vector<TEncoded> encoded(values.size());
+    std::vector<TEncoded> scalarEncoded(values.size());
+    encode(values, std::span(encoded));
+    for (size_t valueIndex = 0; valueIndex < values.size(); valueIndex++)
+    {
+        encode(values.subspan(valueIndex, 1), std::span(scalarEncoded).subspan(valueIndex, 1));
+    }
+
+    return std::memcmp(encoded.data(), scalarEncoded.data(), encoded.size() * sizeof(TEncoded)) == 0;
+}
+
+bool VerifyVertexEncoders()
+{
+    // a sweep past both ends of the clamping range, every unorm8 and unorm16 halfway point
+    // in between, and the values where rounding or saturation usually goes wrong
+    std::vector<float> values;
+    for (int32_t step = -1200; step <= 1200; step++)
+    {
+        values.push_back(static_cast<float>(step) / 1000.0f);
+    }
+
+    for (int32_t step = 0; step < 65536; step += 7)
+    {
+        values.push_back((static_cast<float>(step) + 0.5f) / 65535.0f);
+    }
+
+    for (int32_t step = 0; step < 256; step++)
+    {
+        values.push_back((static_cast<float>(step) + 0.5f) / 255.0f);
+    }
+
+    auto infinity = std::numeric_limits<float>::infinity();
+    for (auto value : { -0.0f, 1e-30f, -1e-30f, 0.99999994f, 1.0000001f, 1e30f, -1e30f, infinity, -infinity })
+    {
+        values.push_back(value);
+    }
+
+    // every vector type gets a multiple of 4 elements, so each SIMD loop runs at least once
+    while (values.size() % 12 != 0)
+    {
+        values.push_back(0.5f);
+    }
+
+    std::span<const glm::vec3> positions(reinterpret_cast<const glm::vec3*>(values.data()), values.size() / 3);
+    std::span<const glm::vec2> uvs(reinterpret_cast<const glm::vec2*>(values.data()), values.size() / 2);
+    std::span<const glm::vec4> colors(reinterpret_cast<const glm::vec4*>(values.data()), values.size() / 4);
+
+    // uneven offsets and scales so the snorm16 range is not just a multiply by 32767
+    auto positionQuantization = ComputePositionQuantization({ -0.7f, -1.3f, 0.1f }, { 0.9f, 0.3f, 0.1f });
+    auto isPositionEncoderExact = IsEncodedLikeScalar<glm::vec3, PackedPositionSnorm16>(positions, [&](auto source, auto destination)
+    {
+        EncodePositionsSnorm16(source, positionQuantization, destination);
+    });
+    auto isUvEncoderExact = IsEncodedLikeScalar<glm::vec2, PackedUvUnorm16>(uvs, [](auto source, auto destination)
+    {
+        EncodeUvsUnorm16(source, destination);
+    });
+    auto isColorEncoderExact = IsEncodedLikeScalar<glm::vec4, PackedColorUnorm8>(colors, [](auto source, auto destination)
+    {
+        EncodeColorsUnorm8(source, destination);
+    });
+
+    return isPositionEncoderExact && isUvEncoderExact && isColorEncoderExact;
+}
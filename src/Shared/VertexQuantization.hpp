@@ -0,0 +1,42 @@
+#pragma once
+
+#include "VertexComponents.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <span>
+
+// position = Offset + Scale * decoded, applied in the vertex shader
+struct PositionQuantization
+{
+    glm::vec3 Offset;
+    glm::vec3 Scale;
+};
+
+// maps the bounds onto [-1, 1] on every axis, flat axes get a scale of 1
+PositionQuantization ComputePositionQuantization(
+    glm::vec3 boundsMin,
+    glm::vec3 boundsMax);
+
+// Encoders take and fill spans of the same size. Positions, uvs and colors go through SSE2 when
+// the target has it, normals and the tails run the scalar path, which rounds the same way.
+void EncodePositionsSnorm16(
+    std::span<const glm::vec3> positions,
+    const PositionQuantization& positionQuantization,
+    std::span<PackedPositionSnorm16> encodedPositions);
+// normals must be unit length
+void EncodeNormalsOctahedral(
+    std::span<const glm::vec3> normals,
+    std::span<PackedNormalOctahedral> encodedNormals);
+// clamps to [0, 1]
+void EncodeUvsUnorm16(
+    std::span<const glm::vec2> uvs,
+    std::span<PackedUvUnorm16> encodedUvs);
+void EncodeColorsUnorm8(
+    std::span<const glm::vec4> colors,
+    std::span<PackedColorUnorm8> encodedColors);
+
+// true when the SIMD encoders produce the same bits as the scalar path, trivially true without SSE2
+bool VerifyVertexEncoders();
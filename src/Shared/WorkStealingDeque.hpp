@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Chase-Lev deque with a fixed capacity. The owning thread pushes and pops at the bottom,
+// every other thread steals from the top. Push fails when full instead of growing.
+template<typename T>
+class WorkStealingDeque
+{
+public:
+    // capacity has to be a power of two
+    explicit WorkStealingDeque(uint32_t capacity)
+        : _items(std::make_unique<std::atomic<T*>[]>(capacity)),
+          _mask(capacity - 1)
+    {
+    }
+
+    bool Push(T* item)
+    {
+        auto bottom = _bottom.load(std::memory_order_relaxed);
+        auto top = _top.load(std::memory_order_acquire);
+        if (bottom - top > static_cast<int64_t>(_mask))
+        {
+            return false;
+        }
+
+        _items[bottom & _mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    T* Pop()
+    {
+        auto bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = _top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto item = _items[bottom & _mask].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // last item, race the thieves for it
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                item = nullptr;
+            }
+
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    T* Steal()
+    {
+        auto top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+
+        auto item = _items[top & _mask].load(std::memory_order_relaxed);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+
+        return item;
+    }
+
+private:
+    std::unique_ptr<std::atomic<T*>[]> _items;
+    int64_t _mask;
+    alignas(64) std::atomic<int64_t> _top = 0;
+    alignas(64) std::atomic<int64_t> _bottom = 0;
+};
@@ -0,0 +1,229 @@
+#include "../../src/Shared/AssetPack.hpp"
+#include "../../src/Shared/Hash.hpp"
+
+#include <lz4hc.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+struct PackedFile
+{
+    std::string Name;
+    std::vector<char> Data;
+    AssetPackCompression Compression = AssetPackCompression::None;
+    uint64_t Size = 0;
+};
+
+static uint64_t AlignUp(
+    uint64_t value,
+    uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool TryCompress(PackedFile& packedFile)
+{
+    auto sourceSize = static_cast<int32_t>(packedFile.Data.size());
+    std::vector<char> compressed(static_cast<size_t>(LZ4_compressBound(sourceSize)));
+    auto compressedSize = LZ4_compress_HC(packedFile.Data.data(), compressed.data(), sourceSize, static_cast<int32_t>(compressed.size()), LZ4HC_CLEVEL_MAX);
+
+    // already compressed formats like png barely shrink, keep those stored so they can be read in place
+    if (compressedSize <= 0 || static_cast<uint64_t>(compressedSize) > packedFile.Data.size() * 7 / 8)
+    {
+        return false;
+    }
+
+    compressed.resize(static_cast<size_t>(compressedSize));
+    packedFile.Data = std::move(compressed);
+    packedFile.Compression = AssetPackCompression::Lz4;
+    return true;
+}
+
+// meshes are uploaded straight from the pack mapping, decompressing them would need a copy first
+static bool IsReadInPlace(const std::filesystem::path& filePath)
+{
+    return filePath.extension() == ".mesh";
+}
+
+static void PrintUsage()
+{
+    spdlog::info("Usage: AssetPacker <input directory> <output file> [--store]");
+    spdlog::info("  entries are named relative to the parent of the input directory, Data/Shaders/Simple.vs.glsl");
+    spdlog::info("  --store skips LZ4 compression, .mesh files are always stored");
+}
+
+int32_t main(
+    int32_t argc,
+    char* argv[])
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::filesystem::path inputDirectoryPath = argv[1];
+    std::filesystem::path outputFilePath = argv[2];
+    auto isCompressionEnabled = true;
+    for (int32_t argumentIndex = 3; argumentIndex < argc; argumentIndex++)
+    {
+        if (std::string_view(argv[argumentIndex]) == "--store")
+        {
+            isCompressionEnabled = false;
+        }
+        else
+        {
+            spdlog::error("Packer: Invalid argument {}", argv[argumentIndex]);
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::error_code errorCode;
+    auto basePath = std::filesystem::absolute(inputDirectoryPath).lexically_normal().parent_path();
+    if (!std::filesystem::is_directory(inputDirectoryPath, errorCode))
+    {
+        spdlog::error("Packer: {} is not a directory", inputDirectoryPath.string());
+        return 1;
+    }
+
+    std::vector<PackedFile> packedFiles;
+    for (auto& directoryEntry : std::filesystem::recursive_directory_iterator(inputDirectoryPath))
+    {
+        if (!directoryEntry.is_regular_file())
+        {
+            continue;
+        }
+
+        std::ifstream file(directoryEntry.path(), std::ios::binary);
+        if (!file.is_open())
+        {
+            spdlog::error("Packer: Unable to read {}", directoryEntry.path().string());
+            return 1;
+        }
+
+        PackedFile packedFile;
+        packedFile.Name = std::filesystem::absolute(directoryEntry.path()).lexically_normal().lexically_relative(basePath).generic_string();
+        packedFile.Data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        packedFile.Size = packedFile.Data.size();
+        if (isCompressionEnabled && !packedFile.Data.empty() && !IsReadInPlace(directoryEntry.path()))
+        {
+            TryCompress(packedFile);
+        }
+
+        packedFiles.push_back(std::move(packedFile));
+    }
+
+    // directory iteration order is unspecified, sorting keeps the pack byte for byte reproducible
+    std::sort(packedFiles.begin(), packedFiles.end(), [](const PackedFile& left, const PackedFile& right)
+    {
+        return left.Name < right.Name;
+    });
+
+    std::string names;
+    std::vector<AssetPackEntry> entries;
+    entries.reserve(packedFiles.size());
+    for (auto& packedFile : packedFiles)
+    {
+        entries.push_back(
+        {
+            .PathHash = HashString(packedFile.Name),
+            .Offset = 0,
+            .StoredSize = packedFile.Data.size(),
+            .Size = packedFile.Size,
+            .NameOffset = static_cast<uint32_t>(names.size()),
+            .NameSize = static_cast<uint32_t>(packedFile.Name.size()),
+            .Compression = packedFile.Compression,
+            .Reserved = 0
+        });
+        names += packedFile.Name;
+    }
+
+    AssetPackHeader header =
+    {
+        .Magic = AssetPackMagic,
+        .Version = AssetPackVersion,
+        .EntryCount = static_cast<uint32_t>(entries.size()),
+        .NamesSize = static_cast<uint32_t>(names.size()),
+        .IndexOffset = AlignUp(sizeof(AssetPackHeader), AssetPackAlignment),
+        .NamesOffset = 0
+    };
+    header.NamesOffset = header.IndexOffset + entries.size() * sizeof(AssetPackEntry);
+
+    auto offset = AlignUp(header.NamesOffset + names.size(), AssetPackAlignment);
+    for (auto& entry : entries)
+    {
+        entry.Offset = offset;
+        offset = AlignUp(offset + entry.StoredSize, AssetPackAlignment);
+    }
+
+    // data stays in name order, the index is what gets sorted for the binary search
+    std::vector<uint32_t> entryOrder(entries.size());
+    for (uint32_t entryIndex = 0; entryIndex < entryOrder.size(); entryIndex++)
+    {
+        entryOrder[entryIndex] = entryIndex;
+    }
+
+    std::stable_sort(entryOrder.begin(), entryOrder.end(), [&](uint32_t left, uint32_t right)
+    {
+        return entries[left].PathHash < entries[right].PathHash;
+    });
+
+    auto temporaryFilePath = outputFilePath;
+    temporaryFilePath += ".tmp";
+    {
+        std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            spdlog::error("Packer: Unable to write {}", temporaryFilePath.string());
+            return 1;
+        }
+
+        auto padTo = [&file](uint64_t position)
+        {
+            static constexpr char padding[AssetPackAlignment] = {};
+            auto paddingSize = position - static_cast<uint64_t>(file.tellp());
+            file.write(padding, static_cast<std::streamsize>(paddingSize));
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        padTo(header.IndexOffset);
+        for (auto entryIndex : entryOrder)
+        {
+            file.write(reinterpret_cast<const char*>(&entries[entryIndex]), sizeof(AssetPackEntry));
+        }
+
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+        for (size_t fileIndex = 0; fileIndex < packedFiles.size(); fileIndex++)
+        {
+            padTo(entries[fileIndex].Offset);
+            file.write(packedFiles[fileIndex].Data.data(), static_cast<std::streamsize>(packedFiles[fileIndex].Data.size()));
+        }
+
+        if (!file)
+        {
+            spdlog::error("Packer: Unable to write {}", temporaryFilePath.string());
+            return 1;
+        }
+    }
+
+    std::filesystem::rename(temporaryFilePath, outputFilePath, errorCode);
+    if (errorCode)
+    {
+        spdlog::error("Packer: Unable to write {}: {}", outputFilePath.string(), errorCode.message());
+        return 1;
+    }
+
+    uint64_t size = 0;
+    uint64_t storedSize = 0;
+    for (auto& entry : entries)
+    {
+        size += entry.Size;
+        storedSize += entry.StoredSize;
+    }
+
+    spdlog::info("Packer: Packed {} files, {} bytes into {} bytes of {}", entries.size(), size, storedSize, outputFilePath.string());
+    return 0;
+}
@@ -0,0 +1,429 @@
+#include "MeshImporter.hpp"
+#include "../../src/Shared/MeshOptimizer.hpp"
+#include "../../src/Shared/VertexQuantization.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string_view>
+
+static uint64_t AlignUp(
+    uint64_t value,
+    uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+template<typename TVertex>
+static std::vector<std::byte> AsBytes(const std::vector<TVertex>& vertices)
+{
+    auto vertexBytes = std::as_bytes(std::span(vertices));
+    return std::vector<std::byte>(vertexBytes.begin(), vertexBytes.end());
+}
+
+static bool IsQuantized(MeshVertexFormat vertexFormat)
+{
+    return
+        vertexFormat == MeshVertexFormat::PositionUvQuantized ||
+        vertexFormat == MeshVertexFormat::PositionColorQuantized ||
+        vertexFormat == MeshVertexFormat::PositionNormalUvQuantized;
+}
+
+// the float format quantized vertices get built in, the optimizer reads float positions
+static MeshVertexFormat GetUnquantizedFormat(MeshVertexFormat vertexFormat)
+{
+    switch (vertexFormat)
+    {
+        case MeshVertexFormat::PositionUvQuantized: return MeshVertexFormat::PositionUv;
+        case MeshVertexFormat::PositionColorQuantized: return MeshVertexFormat::PositionColor;
+        case MeshVertexFormat::PositionNormalUvQuantized: return MeshVertexFormat::PositionNormalUv;
+        default: return vertexFormat;
+    }
+}
+
+static std::vector<std::byte> BuildVertices(
+    const ImportedMesh& importedMesh,
+    MeshVertexFormat vertexFormat)
+{
+    if (vertexFormat == MeshVertexFormat::PositionColor)
+    {
+        std::vector<VertexPositionColor> vertices(importedMesh.Positions.size());
+        for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+        {
+            vertices[vertexIndex] = { .Position = importedMesh.Positions[vertexIndex], .Color = glm::vec3(importedMesh.Colors[vertexIndex]) };
+        }
+
+        return AsBytes(vertices);
+    }
+
+    if (vertexFormat == MeshVertexFormat::PositionNormalUv)
+    {
+        std::vector<VertexPositionNormalUv> vertices(importedMesh.Positions.size());
+        for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+        {
+            vertices[vertexIndex] =
+            {
+                .Position = importedMesh.Positions[vertexIndex],
+                .Normal = importedMesh.Normals[vertexIndex],
+                .Uv = importedMesh.Uvs[vertexIndex]
+            };
+        }
+
+        return AsBytes(vertices);
+    }
+
+    std::vector<VertexPositionUv> vertices(importedMesh.Positions.size());
+    for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+    {
+        vertices[vertexIndex] = { .Position = importedMesh.Positions[vertexIndex], .Uv = importedMesh.Uvs[vertexIndex] };
+    }
+
+    return AsBytes(vertices);
+}
+
+template<typename TVertex>
+static std::vector<TVertex> FromBytes(std::span<const std::byte> vertexBytes)
+{
+    std::vector<TVertex> vertices(vertexBytes.size() / sizeof(TVertex));
+    std::memcpy(vertices.data(), vertexBytes.data(), vertices.size() * sizeof(TVertex));
+    return vertices;
+}
+
+static void WarnIfUvsGetClamped(
+    std::span<const glm::vec2> uvs,
+    std::string_view formatName)
+{
+    auto isUvClamped = std::any_of(uvs.begin(), uvs.end(), [](const glm::vec2& uv)
+    {
+        return uv.x < 0.0f || uv.x > 1.0f || uv.y < 0.0f || uv.y > 1.0f;
+    });
+    if (isUvClamped)
+    {
+        spdlog::warn("Converter: Uvs outside of [0, 1] get clamped by {}", formatName);
+    }
+}
+
+static std::vector<std::byte> QuantizeVertices(
+    std::span<const std::byte> vertexBytes,
+    MeshVertexFormat vertexFormat,
+    const PositionQuantization& positionQuantization)
+{
+    if (vertexFormat == MeshVertexFormat::PositionColorQuantized)
+    {
+        auto vertices = FromBytes<VertexPositionColor>(vertexBytes);
+        std::vector<glm::vec3> positions(vertices.size());
+        std::vector<glm::vec4> colors(vertices.size());
+        for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+        {
+            positions[vertexIndex] = vertices[vertexIndex].Position;
+            colors[vertexIndex] = glm::vec4(vertices[vertexIndex].Color, 1.0f);
+        }
+
+        std::vector<PackedPositionSnorm16> encodedPositions(vertices.size());
+        std::vector<PackedColorUnorm8> encodedColors(vertices.size());
+        EncodePositionsSnorm16(positions, positionQuantization, encodedPositions);
+        EncodeColorsUnorm8(colors, encodedColors);
+
+        std::vector<VertexPositionColorQuantized> quantizedVertices(vertices.size());
+        for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+        {
+            quantizedVertices[vertexIndex] = { .Position = encodedPositions[vertexIndex], .Color = encodedColors[vertexIndex] };
+        }
+
+        return AsBytes(quantizedVertices);
+    }
+
+    if (vertexFormat == MeshVertexFormat::PositionNormalUvQuantized)
+    {
+        auto vertices = FromBytes<VertexPositionNormalUv>(vertexBytes);
+        std::vector<glm::vec3> positions(vertices.size());
+        std::vector<glm::vec3> normals(vertices.size());
+        std::vector<glm::vec2> uvs(vertices.size());
+        for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+        {
+            // the octahedral encoding expects unit normals, degenerate ones fall back to +z
+            auto& normal = vertices[vertexIndex].Normal;
+            auto length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+            positions[vertexIndex] = vertices[vertexIndex].Position;
+            normals[vertexIndex] = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+            uvs[vertexIndex] = vertices[vertexIndex].Uv;
+        }
+
+        WarnIfUvsGetClamped(uvs, "PositionNormalUvQuantized");
+
+        std::vector<PackedPositionSnorm16> encodedPositions(vertices.size());
+        std::vector<PackedNormalOctahedral> encodedNormals(vertices.size());
+        std::vector<PackedUvUnorm16> encodedUvs(vertices.size());
+        EncodePositionsSnorm16(positions, positionQuantization, encodedPositions);
+        EncodeNormalsOctahedral(normals, encodedNormals);
+        EncodeUvsUnorm16(uvs, encodedUvs);
+
+        std::vector<VertexPositionNormalUvQuantized> quantizedVertices(vertices.size());
+        for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+        {
+            quantizedVertices[vertexIndex] =
+            {
+                .Position = encodedPositions[vertexIndex],
+                .Normal = encodedNormals[vertexIndex],
+                .Uv = encodedUvs[vertexIndex]
+            };
+        }
+
+        return AsBytes(quantizedVertices);
+    }
+
+    auto vertices = FromBytes<VertexPositionUv>(vertexBytes);
+    std::vector<glm::vec3> positions(vertices.size());
+    std::vector<glm::vec2> uvs(vertices.size());
+    for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+    {
+        positions[vertexIndex] = vertices[vertexIndex].Position;
+        uvs[vertexIndex] = vertices[vertexIndex].Uv;
+    }
+
+    WarnIfUvsGetClamped(uvs, "PositionUvQuantized");
+
+    std::vector<PackedPositionSnorm16> encodedPositions(vertices.size());
+    std::vector<PackedUvUnorm16> encodedUvs(vertices.size());
+    EncodePositionsSnorm16(positions, positionQuantization, encodedPositions);
+    EncodeUvsUnorm16(uvs, encodedUvs);
+
+    std::vector<VertexPositionUvQuantized> quantizedVertices(vertices.size());
+    for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+    {
+        quantizedVertices[vertexIndex] = { .Position = encodedPositions[vertexIndex], .Uv = encodedUvs[vertexIndex] };
+    }
+
+    return AsBytes(quantizedVertices);
+}
+
+static void OptimizeMesh(
+    std::vector<std::byte>& vertices,
+    uint32_t vertexStride,
+    std::vector<uint32_t>& indices,
+    std::span<const MeshSubmesh> submeshes)
+{
+    auto before = SimulateVertexCache(indices, static_cast<uint32_t>(vertices.size() / vertexStride));
+    auto vertexCountBefore = vertices.size() / vertexStride;
+
+    uint32_t uniqueVertexCount = 0;
+    auto remap = GenerateVertexRemap(vertices, vertexStride, uniqueVertexCount);
+    vertices = RemapVertices(vertices, vertexStride, remap, uniqueVertexCount);
+    RemapIndices(indices, remap);
+
+    // triangles must stay inside the index range of their submesh
+    for (auto& submesh : submeshes)
+    {
+        auto submeshIndices = std::span(indices).subspan(submesh.FirstIndex, submesh.IndexCount);
+        OptimizeVertexCache(submeshIndices, uniqueVertexCount);
+        OptimizeOverdraw(submeshIndices, vertices, vertexStride);
+    }
+
+    vertices = OptimizeVertexFetch(indices, vertices, vertexStride);
+    auto after = SimulateVertexCache(indices, static_cast<uint32_t>(vertices.size() / vertexStride));
+    spdlog::info(
+        "Converter: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} -> {} vertices",
+        before.Acmr,
+        after.Acmr,
+        before.Atvr,
+        after.Atvr,
+        vertexCountBefore,
+        vertices.size() / vertexStride);
+}
+
+static bool WriteMeshFile(
+    const std::filesystem::path& filePath,
+    const ImportedMesh& importedMesh,
+    MeshVertexFormat vertexFormat,
+    bool isIndex32Forced,
+    bool isOptimized)
+{
+    auto unquantizedFormat = GetUnquantizedFormat(vertexFormat);
+    auto vertices = BuildVertices(importedMesh, unquantizedFormat);
+    auto meshIndices = importedMesh.Indices;
+    if (isOptimized)
+    {
+        OptimizeMesh(vertices, GetMeshVertexStride(unquantizedFormat), meshIndices, importedMesh.Submeshes);
+    }
+
+    auto vertexCount = vertices.size() / GetMeshVertexStride(unquantizedFormat);
+    auto vertexStride = GetMeshVertexStride(vertexFormat);
+    auto indexSize = !isIndex32Forced && vertexCount <= std::numeric_limits<uint16_t>::max() + 1ull ? 2u : 4u;
+
+    MeshFileHeader header =
+    {
+        .Magic = MeshFileMagic,
+        .Version = MeshFileVersion,
+        .VertexFormat = vertexFormat,
+        .VertexStride = vertexStride,
+        .VertexCount = static_cast<uint32_t>(vertexCount),
+        .IndexCount = static_cast<uint32_t>(meshIndices.size()),
+        .IndexSize = indexSize,
+        .SubmeshCount = static_cast<uint32_t>(importedMesh.Submeshes.size()),
+        .BoundsMin = {},
+        .BoundsMax = {},
+        .PositionOffset = { 0.0f, 0.0f, 0.0f },
+        .PositionScale = { 1.0f, 1.0f, 1.0f },
+        .SubmeshOffset = AlignUp(sizeof(MeshFileHeader), MeshFileAlignment),
+        .VertexOffset = 0,
+        .IndexOffset = 0
+    };
+    if (!importedMesh.Positions.empty())
+    {
+        auto boundsMin = importedMesh.Positions.front();
+        auto boundsMax = importedMesh.Positions.front();
+        for (auto& position : importedMesh.Positions)
+        {
+            boundsMin = glm::min(boundsMin, position);
+            boundsMax = glm::max(boundsMax, position);
+        }
+
+        std::copy_n(&boundsMin.x, 3, header.BoundsMin);
+        std::copy_n(&boundsMax.x, 3, header.BoundsMax);
+
+        if (IsQuantized(vertexFormat))
+        {
+            auto positionQuantization = ComputePositionQuantization(boundsMin, boundsMax);
+            vertices = QuantizeVertices(vertices, vertexFormat, positionQuantization);
+            std::copy_n(&positionQuantization.Offset.x, 3, header.PositionOffset);
+            std::copy_n(&positionQuantization.Scale.x, 3, header.PositionScale);
+        }
+    }
+
+    header.VertexOffset = AlignUp(header.SubmeshOffset + importedMesh.Submeshes.size() * sizeof(MeshSubmesh), MeshFileAlignment);
+    header.IndexOffset = AlignUp(header.VertexOffset + vertices.size(), MeshFileAlignment);
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    auto padTo = [&file](uint64_t position)
+    {
+        static constexpr char padding[MeshFileAlignment] = {};
+        auto paddingSize = position - static_cast<uint64_t>(file.tellp());
+        file.write(padding, static_cast<std::streamsize>(paddingSize));
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    padTo(header.SubmeshOffset);
+    file.write(reinterpret_cast<const char*>(importedMesh.Submeshes.data()), static_cast<std::streamsize>(importedMesh.Submeshes.size() * sizeof(MeshSubmesh)));
+    padTo(header.VertexOffset);
+    file.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size()));
+    padTo(header.IndexOffset);
+    if (indexSize == 2)
+    {
+        std::vector<uint16_t> indices(meshIndices.begin(), meshIndices.end());
+        file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size() * sizeof(uint16_t)));
+    }
+    else
+    {
+        file.write(reinterpret_cast<const char*>(meshIndices.data()), static_cast<std::streamsize>(meshIndices.size() * sizeof(uint32_t)));
+    }
+
+    return static_cast<bool>(file);
+}
+
+static void PrintUsage()
+{
+    spdlog::info("Usage: MeshConverter <input.obj|input.gltf|input.glb> <output.mesh> [--format=PositionUv|PositionColor|PositionNormalUv|PositionUvQuantized|PositionColorQuantized|PositionNormalUvQuantized] [--index32] [--no-optimize]");
+}
+
+int32_t main(
+    int32_t argc,
+    char* argv[])
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::filesystem::path inputFilePath = argv[1];
+    std::filesystem::path outputFilePath = argv[2];
+    auto vertexFormat = MeshVertexFormat::PositionUv;
+    auto isIndex32Forced = false;
+    auto isOptimized = true;
+    for (int32_t argumentIndex = 3; argumentIndex < argc; argumentIndex++)
+    {
+        std::string_view argument = argv[argumentIndex];
+        if (argument == "--format=PositionUv")
+        {
+            vertexFormat = MeshVertexFormat::PositionUv;
+        }
+        else if (argument == "--format=PositionColor")
+        {
+            vertexFormat = MeshVertexFormat::PositionColor;
+        }
+        else if (argument == "--format=PositionNormalUv")
+        {
+            vertexFormat = MeshVertexFormat::PositionNormalUv;
+        }
+        else if (argument == "--format=PositionUvQuantized")
+        {
+            vertexFormat = MeshVertexFormat::PositionUvQuantized;
+        }
+        else if (argument == "--format=PositionColorQuantized")
+        {
+            vertexFormat = MeshVertexFormat::PositionColorQuantized;
+        }
+        else if (argument == "--format=PositionNormalUvQuantized")
+        {
+            vertexFormat = MeshVertexFormat::PositionNormalUvQuantized;
+        }
+        else if (argument == "--index32")
+        {
+            isIndex32Forced = true;
+        }
+        else if (argument == "--no-optimize")
+        {
+            isOptimized = false;
+        }
+        else
+        {
+            spdlog::error("Converter: Invalid argument {}", argument);
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // the vertices of the same mesh must not depend on whether the build machine has SSE2
+    if (IsQuantized(vertexFormat) && !VerifyVertexEncoders())
+    {
+        spdlog::error("Converter: The SIMD vertex encoders disagree with the scalar ones, not writing {}", outputFilePath.string());
+        return 1;
+    }
+
+    auto extension = inputFilePath.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char character)
+    {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+    });
+
+    auto importedMesh = extension == ".obj"
+        ? ImportObj(inputFilePath)
+        : ImportGltf(inputFilePath);
+    if (!importedMesh.has_value())
+    {
+        spdlog::error("Converter: {}", importedMesh.error());
+        return 1;
+    }
+
+    if (!WriteMeshFile(outputFilePath, importedMesh.value(), vertexFormat, isIndex32Forced, isOptimized))
+    {
+        spdlog::error("Converter: Unable to write {}", outputFilePath.string());
+        return 1;
+    }
+
+    spdlog::info(
+        "Converter: Wrote {} indices in {} submeshes to {}",
+        importedMesh->Indices.size(),
+        importedMesh->Submeshes.size(),
+        outputFilePath.string());
+    return 0;
+}
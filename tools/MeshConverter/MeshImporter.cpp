@@ -0,0 +1,308 @@
+#include "MeshImporter.hpp"
+#include "../../src/Shared/Hash.hpp"
+
+#define CGLTF_IMPLEMENTATION
+#include <cgltf.h>
+
+#include <array>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+static std::string_view NextToken(std::string_view& line)
+{
+    auto tokenStart = line.find_first_not_of(" \t\r");
+    if (tokenStart == std::string_view::npos)
+    {
+        line = {};
+        return {};
+    }
+
+    auto tokenEnd = line.find_first_of(" \t\r", tokenStart);
+    auto token = line.substr(tokenStart, tokenEnd - tokenStart);
+    line = tokenEnd == std::string_view::npos ? std::string_view() : line.substr(tokenEnd);
+    return token;
+}
+
+static bool TryParseFloats(
+    std::string_view& line,
+    float* values,
+    size_t valueCount)
+{
+    for (size_t valueIndex = 0; valueIndex < valueCount; valueIndex++)
+    {
+        auto token = NextToken(line);
+        auto [_, errorCode] = std::from_chars(token.data(), token.data() + token.size(), values[valueIndex]);
+        if (token.empty() || errorCode != std::errc())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// OBJ indices are 1 based, negative ones count back from the last element read so far
+static int64_t ResolveObjIndex(
+    std::string_view token,
+    size_t elementCount)
+{
+    int64_t index = 0;
+    auto [_, errorCode] = std::from_chars(token.data(), token.data() + token.size(), index);
+    if (token.empty() || errorCode != std::errc() || index == 0)
+    {
+        return -1;
+    }
+
+    index = index < 0 ? static_cast<int64_t>(elementCount) + index : index - 1;
+    return index < static_cast<int64_t>(elementCount) ? index : -1;
+}
+
+// position, uv and normal index, -1 when the face leaves one out
+using ObjVertexKey = std::array<int64_t, 3>;
+
+struct ObjVertexKeyHash
+{
+    size_t operator()(const ObjVertexKey& vertexKey) const
+    {
+        return static_cast<size_t>(HashValue(vertexKey));
+    }
+};
+
+std::expected<ImportedMesh, std::string> ImportObj(const std::filesystem::path& filePath)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open())
+    {
+        return std::unexpected(std::format("Io: Unable to read from file {}", filePath.string()));
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec4> colors;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> uvs;
+    std::unordered_map<std::string, uint32_t> materialIndices;
+    std::unordered_map<ObjVertexKey, uint32_t, ObjVertexKeyHash> vertexIndices;
+
+    ImportedMesh importedMesh;
+    importedMesh.Submeshes.push_back({ .FirstIndex = 0, .IndexCount = 0, .MaterialIndex = 0, .Reserved = 0 });
+
+    std::string lineText;
+    uint32_t lineNumber = 0;
+    while (std::getline(file, lineText))
+    {
+        lineNumber++;
+        std::string_view line = lineText;
+        auto keyword = NextToken(line);
+        if (keyword == "v")
+        {
+            // "v x y z r g b" is a common extension for vertex colors
+            glm::vec3 position = {};
+            glm::vec4 color = glm::vec4(1.0f);
+            if (!TryParseFloats(line, &position.x, 3))
+            {
+                return std::unexpected(std::format("Obj: Invalid position in {}({})", filePath.string(), lineNumber));
+            }
+
+            TryParseFloats(line, &color.x, 3);
+            positions.push_back(position);
+            colors.push_back(color);
+        }
+        else if (keyword == "vn")
+        {
+            glm::vec3 normal = {};
+            if (!TryParseFloats(line, &normal.x, 3))
+            {
+                return std::unexpected(std::format("Obj: Invalid normal in {}({})", filePath.string(), lineNumber));
+            }
+
+            normals.push_back(normal);
+        }
+        else if (keyword == "vt")
+        {
+            glm::vec2 uv = {};
+            if (!TryParseFloats(line, &uv.x, 2))
+            {
+                return std::unexpected(std::format("Obj: Invalid texture coordinate in {}({})", filePath.string(), lineNumber));
+            }
+
+            uvs.push_back(uv);
+        }
+        else if (keyword == "usemtl")
+        {
+            auto materialName = std::string(NextToken(line));
+            auto materialIndex = materialIndices.emplace(materialName, static_cast<uint32_t>(materialIndices.size())).first->second;
+            auto& submesh = importedMesh.Submeshes.back();
+            if (submesh.IndexCount > 0)
+            {
+                importedMesh.Submeshes.push_back({ .FirstIndex = static_cast<uint32_t>(importedMesh.Indices.size()), .IndexCount = 0, .MaterialIndex = materialIndex, .Reserved = 0 });
+            }
+            else
+            {
+                submesh.MaterialIndex = materialIndex;
+            }
+        }
+        else if (keyword == "f")
+        {
+            std::vector<uint32_t> faceIndices;
+            for (auto vertexToken = NextToken(line); !vertexToken.empty(); vertexToken = NextToken(line))
+            {
+                // v, v/vt, v//vn or v/vt/vn
+                auto separator = vertexToken.find('/');
+                auto positionIndex = ResolveObjIndex(vertexToken.substr(0, separator), positions.size());
+                auto uvToken = separator == std::string_view::npos ? std::string_view() : vertexToken.substr(separator + 1);
+                auto normalSeparator = uvToken.find('/');
+                auto normalToken = normalSeparator == std::string_view::npos ? std::string_view() : uvToken.substr(normalSeparator + 1);
+                uvToken = uvToken.substr(0, normalSeparator);
+                auto uvIndex = uvToken.empty() ? -1 : ResolveObjIndex(uvToken, uvs.size());
+                auto normalIndex = normalToken.empty() ? -1 : ResolveObjIndex(normalToken, normals.size());
+                if (positionIndex < 0 || (!uvToken.empty() && uvIndex < 0) || (!normalToken.empty() && normalIndex < 0))
+                {
+                    return std::unexpected(std::format("Obj: Invalid face in {}({})", filePath.string(), lineNumber));
+                }
+
+                ObjVertexKey vertexKey = { positionIndex, uvIndex, normalIndex };
+                auto [vertexIndex, isNewVertex] = vertexIndices.emplace(vertexKey, static_cast<uint32_t>(importedMesh.Positions.size()));
+                if (isNewVertex)
+                {
+                    importedMesh.Positions.push_back(positions[positionIndex]);
+                    importedMesh.Colors.push_back(colors[positionIndex]);
+                    importedMesh.Normals.push_back(normalIndex >= 0 ? normals[normalIndex] : glm::vec3(0.0f, 0.0f, 1.0f));
+                    importedMesh.Uvs.push_back(uvIndex >= 0 ? uvs[uvIndex] : glm::vec2(0.0f));
+                }
+
+                faceIndices.push_back(vertexIndex->second);
+            }
+
+            if (faceIndices.size() < 3)
+            {
+                return std::unexpected(std::format("Obj: Face with less than 3 vertices in {}({})", filePath.string(), lineNumber));
+            }
+
+            for (size_t cornerIndex = 1; cornerIndex + 1 < faceIndices.size(); cornerIndex++)
+            {
+                importedMesh.Indices.push_back(faceIndices[0]);
+                importedMesh.Indices.push_back(faceIndices[cornerIndex]);
+                importedMesh.Indices.push_back(faceIndices[cornerIndex + 1]);
+            }
+
+            importedMesh.Submeshes.back().IndexCount = static_cast<uint32_t>(importedMesh.Indices.size()) - importedMesh.Submeshes.back().FirstIndex;
+        }
+    }
+
+    return importedMesh;
+}
+
+std::expected<ImportedMesh, std::string> ImportGltf(const std::filesystem::path& filePath)
+{
+    auto filePathText = filePath.string();
+    cgltf_options options = {};
+    cgltf_data* data = nullptr;
+    if (cgltf_parse_file(&options, filePathText.c_str(), &data) != cgltf_result_success)
+    {
+        return std::unexpected(std::format("Gltf: Unable to parse {}", filePathText));
+    }
+
+    if (cgltf_load_buffers(&options, data, filePathText.c_str()) != cgltf_result_success)
+    {
+        cgltf_free(data);
+        return std::unexpected(std::format("Gltf: Unable to load the buffers of {}", filePathText));
+    }
+
+    ImportedMesh importedMesh;
+    for (cgltf_size meshIndex = 0; meshIndex < data->meshes_count; meshIndex++)
+    {
+        auto& mesh = data->meshes[meshIndex];
+        for (cgltf_size primitiveIndex = 0; primitiveIndex < mesh.primitives_count; primitiveIndex++)
+        {
+            auto& primitive = mesh.primitives[primitiveIndex];
+            if (primitive.type != cgltf_primitive_type_triangles)
+            {
+                continue;
+            }
+
+            const cgltf_accessor* positionAccessor = nullptr;
+            const cgltf_accessor* normalAccessor = nullptr;
+            const cgltf_accessor* uvAccessor = nullptr;
+            const cgltf_accessor* colorAccessor = nullptr;
+            for (cgltf_size attributeIndex = 0; attributeIndex < primitive.attributes_count; attributeIndex++)
+            {
+                auto& attribute = primitive.attributes[attributeIndex];
+                if (attribute.type == cgltf_attribute_type_position)
+                {
+                    positionAccessor = attribute.data;
+                }
+                else if (attribute.type == cgltf_attribute_type_normal)
+                {
+                    normalAccessor = attribute.data;
+                }
+                else if (attribute.type == cgltf_attribute_type_texcoord && attribute.index == 0)
+                {
+                    uvAccessor = attribute.data;
+                }
+                else if (attribute.type == cgltf_attribute_type_color && attribute.index == 0)
+                {
+                    colorAccessor = attribute.data;
+                }
+            }
+
+            if (positionAccessor == nullptr)
+            {
+                continue;
+            }
+
+            auto baseVertex = static_cast<uint32_t>(importedMesh.Positions.size());
+            for (cgltf_size vertexIndex = 0; vertexIndex < positionAccessor->count; vertexIndex++)
+            {
+                glm::vec3 position = {};
+                glm::vec3 normal = glm::vec3(0.0f, 0.0f, 1.0f);
+                glm::vec2 uv = {};
+                glm::vec4 color = glm::vec4(1.0f);
+                cgltf_accessor_read_float(positionAccessor, vertexIndex, &position.x, 3);
+                if (normalAccessor != nullptr)
+                {
+                    cgltf_accessor_read_float(normalAccessor, vertexIndex, &normal.x, 3);
+                }
+
+                if (uvAccessor != nullptr)
+                {
+                    cgltf_accessor_read_float(uvAccessor, vertexIndex, &uv.x, 2);
+                }
+
+                if (colorAccessor != nullptr)
+                {
+                    cgltf_accessor_read_float(colorAccessor, vertexIndex, &color.x, 4);
+                }
+
+                importedMesh.Positions.push_back(position);
+                importedMesh.Normals.push_back(normal);
+                importedMesh.Uvs.push_back(uv);
+                importedMesh.Colors.push_back(color);
+            }
+
+            MeshSubmesh submesh =
+            {
+                .FirstIndex = static_cast<uint32_t>(importedMesh.Indices.size()),
+                .IndexCount = 0,
+                .MaterialIndex = primitive.material != nullptr ? static_cast<uint32_t>(primitive.material - data->materials) : 0,
+                .Reserved = 0
+            };
+
+            // non indexed primitives draw their vertices in order
+            auto indexCount = primitive.indices != nullptr ? primitive.indices->count : positionAccessor->count;
+            for (cgltf_size index = 0; index < indexCount; index++)
+            {
+                auto vertexIndex = primitive.indices != nullptr ? cgltf_accessor_read_index(primitive.indices, index) : index;
+                importedMesh.Indices.push_back(baseVertex + static_cast<uint32_t>(vertexIndex));
+            }
+
+            submesh.IndexCount = static_cast<uint32_t>(importedMesh.Indices.size()) - submesh.FirstIndex;
+            importedMesh.Submeshes.push_back(submesh);
+        }
+    }
+
+    cgltf_free(data);
+    return importedMesh;
+}
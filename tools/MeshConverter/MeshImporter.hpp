@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../../src/Shared/MeshFile.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// One vertex per unique attribute combination, every attribute array has Positions.size() entries
+struct ImportedMesh
+{
+    std::vector<glm::vec3> Positions;
+    // (0, 0, 1) when the source has none
+    std::vector<glm::vec3> Normals;
+    std::vector<glm::vec2> Uvs;
+    std::vector<glm::vec4> Colors;
+    std::vector<uint32_t> Indices;
+    std::vector<MeshSubmesh> Submeshes;
+};
+
+// faces are fan triangulated, every usemtl starts a new submesh
+std::expected<ImportedMesh, std::string> ImportObj(const std::filesystem::path& filePath);
+// triangle primitives of every mesh, each one becomes a submesh, node transforms are not applied
+std::expected<ImportedMesh, std::string> ImportGltf(const std::filesystem::path& filePath);